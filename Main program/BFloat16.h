@@ -0,0 +1,50 @@
+#ifndef BFLOAT16_H
+#define BFLOAT16_H
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <istream>
+#include <ostream>
+
+// 16-бітне число з плаваючою комою: старші 16 біт float (знак, 8 біт порядку, 7 біт мантиси).
+// Діапазон як у float, точність ~3 десяткові цифри. Використовується лише для зберігання -
+// арифметика виконується після перетворення у float/double.
+struct BFloat16 {
+    uint16_t bits;
+    
+    BFloat16() : bits(0) {}
+    
+    // Округлення до найближчого, при рівності - до парного
+    explicit BFloat16(float value) {
+        uint32_t u;
+        std::memcpy(&u, &value, sizeof(u));
+        if (std::isnan(value)) {
+            bits = static_cast<uint16_t>((u >> 16) | 0x40);
+            return;
+        }
+        u += 0x7FFF + ((u >> 16) & 1);
+        bits = static_cast<uint16_t>(u >> 16);
+    }
+    
+    explicit BFloat16(double value) : BFloat16(static_cast<float>(value)) {}
+    
+    operator float() const {
+        uint32_t u = static_cast<uint32_t>(bits) << 16;
+        float value;
+        std::memcpy(&value, &u, sizeof(value));
+        return value;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const BFloat16& value) {
+    return out << static_cast<float>(value);
+}
+
+inline std::istream& operator>>(std::istream& in, BFloat16& value) {
+    float f;
+    if (in >> f) value = BFloat16(f);
+    return in;
+}
+
+#endif
\ No newline at end of file
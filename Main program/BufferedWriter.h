@@ -0,0 +1,189 @@
+#ifndef BUFFEREDWRITER_H
+#define BUFFEREDWRITER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+
+enum class ExportFormat {
+    TSV,
+    CSV,
+    Binary    // лише значення як сирі float64, без заголовка
+};
+
+class BufferedWriter {
+private:
+    std::ofstream out;
+    std::vector<char> buffer;
+    size_t used;
+
+    void ensureSpace(size_t bytes) {
+        if (used + bytes > buffer.size()) {
+            flush();
+            if (bytes > buffer.size()) buffer.resize(bytes);
+        }
+    }
+
+public:
+    BufferedWriter(const std::string& filename, bool binary = false, size_t capacity = size_t(1) << 20)
+        : out(filename, binary ? std::ios::out | std::ios::binary : std::ios::out),
+          buffer(capacity), used(0) {
+        if (!out) throw std::runtime_error("Cannot open file for writing");
+    }
+
+    ~BufferedWriter() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    void writeRaw(const void* data, size_t bytes) {
+        ensureSpace(bytes);
+        std::memcpy(buffer.data() + used, data, bytes);
+        used += bytes;
+    }
+
+    void write(const std::string& text) {
+        writeRaw(text.data(), text.size());
+    }
+
+    void writeChar(char c) {
+        ensureSpace(1);
+        buffer[used++] = c;
+    }
+
+    // Найкоротше представлення, що однозначно відновлює double
+    void writeDouble(double value) {
+        ensureSpace(32);
+        auto res = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value);
+        used = res.ptr - buffer.data();
+    }
+
+    void writeInteger(long long value) {
+        ensureSpace(24);
+        auto res = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value);
+        used = res.ptr - buffer.data();
+    }
+
+    void writeBinaryDoubles(const double* values, size_t count) {
+        writeRaw(values, count * sizeof(double));
+    }
+
+    void flush() {
+        if (used > 0) {
+            out.write(buffer.data(), static_cast<std::streamsize>(used));
+            used = 0;
+            if (!out) throw std::runtime_error("Error while writing to file");
+        }
+    }
+};
+
+// Фоновий потік запису: виробники кладуть (ім'я, вміст) в обмежену чергу і не чекають на диск.
+// Без archiveFilename кожен елемент пишеться в окремий файл, інакше все йде в один архів,
+// де ім'я елемента стає заголовком секції.
+class AsyncFileWriter {
+private:
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<std::pair<std::string, std::string>> queue;
+    size_t capacity;
+    bool closed;
+    std::exception_ptr error;
+    std::ofstream archive;
+    bool useArchive;
+    std::thread worker;
+    
+    void run() {
+        while (true) {
+            std::pair<std::string, std::string> item;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                notEmpty.wait(lock, [this]() { return closed || !queue.empty(); });
+                if (queue.empty()) return;
+                item = std::move(queue.front());
+                queue.pop_front();
+            }
+            notFull.notify_one();
+            
+            try {
+                if (useArchive) {
+                    archive << item.first << "\n" << item.second << "\n";
+                    if (!archive) throw std::runtime_error("Error while writing archive");
+                } else {
+                    std::ofstream out(item.first, std::ios::binary);
+                    if (!out) throw std::runtime_error("Cannot open file for writing");
+                    out.write(item.second.data(), static_cast<std::streamsize>(item.second.size()));
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+        }
+    }
+    
+public:
+    explicit AsyncFileWriter(size_t queueCapacity = 256)
+        : capacity(queueCapacity), closed(false), useArchive(false) {
+        worker = std::thread(&AsyncFileWriter::run, this);
+    }
+    
+    AsyncFileWriter(const std::string& archiveFilename, size_t queueCapacity = 256)
+        : capacity(queueCapacity), closed(false), archive(archiveFilename, std::ios::binary), useArchive(true) {
+        if (!archive) throw std::runtime_error("Cannot open file for writing");
+        worker = std::thread(&AsyncFileWriter::run, this);
+    }
+    
+    ~AsyncFileWriter() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+    
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+    
+    void enqueue(std::string name, std::string content) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notFull.wait(lock, [this]() { return closed || queue.size() < capacity; });
+            if (closed) throw std::runtime_error("Writer is closed");
+            queue.emplace_back(std::move(name), std::move(content));
+        }
+        notEmpty.notify_one();
+    }
+    
+    // Дочікується запису всієї черги; повторно кидає першу помилку вводу-виводу
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+        if (worker.joinable()) worker.join();
+        if (useArchive && archive.is_open()) archive.close();
+        
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error) {
+            std::exception_ptr e = error;
+            error = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+};
+
+#endif
\ No newline at end of file
@@ -5,76 +5,481 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <charconv>
+#include "BufferedWriter.h"
+#include "ParallelUtils.h"
+
+// Кеш відрендереного тексту, ключ - структурний хеш виразу та ім'я функції.
+// Один екземпляр розділяється між експортерами (кожен пише у свій слот) і потоками.
+class ExportCache {
+private:
+    struct Entry {
+        std::shared_ptr<MathExpression> expression;
+        std::string name;
+        std::unordered_map<std::string, std::string> rendered;
+    };
+    
+    mutable std::shared_mutex mutex;
+    std::unordered_multimap<size_t, Entry> entries;
+    mutable std::atomic<size_t> hits{0};
+    mutable std::atomic<size_t> misses{0};
+    
+    static size_t keyOf(const MathFunction& func) {
+        size_t h = func.getExpression()->structuralHash();
+        return h ^ (std::hash<std::string>()(func.getName()) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+    }
+    
+    static bool matches(const Entry& entry, const MathFunction& func) {
+        return entry.name == func.getName() && entry.expression->structurallyEquals(*func.getExpression());
+    }
+    
+public:
+    bool lookup(const MathFunction& func, const std::string& slot, std::string& out) const {
+        size_t key = keyOf(func);
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        
+        auto range = entries.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (!matches(it->second, func)) continue;
+            auto found = it->second.rendered.find(slot);
+            if (found == it->second.rendered.end()) break;
+            out = found->second;
+            ++hits;
+            return true;
+        }
+        ++misses;
+        return false;
+    }
+    
+    void store(const MathFunction& func, const std::string& slot, const std::string& text) {
+        size_t key = keyOf(func);
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        
+        auto range = entries.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (matches(it->second, func)) {
+                it->second.rendered[slot] = text;
+                return;
+            }
+        }
+        
+        Entry entry{func.getExpression(), func.getName(), {}};
+        entry.rendered[slot] = text;
+        entries.emplace(key, std::move(entry));
+    }
+    
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return entries.size();
+    }
+    
+    size_t hitCount() const { return hits; }
+    size_t missCount() const { return misses; }
+    
+    void clear() {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        entries.clear();
+        hits = 0;
+        misses = 0;
+    }
+};
 
 class ComputerAlgebraInterface {
+protected:
+    std::shared_ptr<ExportCache> cache;
+    
 public:
     virtual ~ComputerAlgebraInterface() = default;
     
-    virtual std::string exportToFormat(const MathFunction& func) const = 0;
-    virtual void exportToFile(const MathFunction& func, const std::string& filename) const = 0;
+    // Дописує відрендерений текст у out; буфер можна перевикористовувати між викликами
+    virtual void exportToBuffer(const MathFunction& func, std::string& out) const = 0;
+    // Повний вміст файлу для цільової системи
+    virtual void writeDocument(const MathFunction& func, std::ostream& out) const = 0;
     virtual std::string getSystemName() const = 0;
+    
+    std::string exportToFormat(const MathFunction& func) const {
+        std::string out;
+        exportToBuffer(func, out);
+        return out;
+    }
+    
+    virtual void exportToFile(const MathFunction& func, const std::string& filename) const {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Cannot open file");
+        writeDocument(func, out);
+    }
+    
+    std::string exportToDocument(const MathFunction& func) const {
+        std::ostringstream out;
+        writeDocument(func, out);
+        return out.str();
+    }
+    
+    void setCache(std::shared_ptr<ExportCache> sharedCache) {
+        cache = sharedCache;
+    }
+    
+    // exportToFormat через кеш (якщо він заданий)
+    std::string render(const MathFunction& func) const {
+        std::string text;
+        if (cache && cache->lookup(func, getSystemName(), text)) return text;
+        
+        text = exportToFormat(func);
+        if (cache) cache->store(func, getSystemName(), text);
+        return text;
+    }
+    
+    // Рендер похідної зберігається в записі вихідної функції, тож при влучанні похідна не обчислюється
+    std::string renderDerivative(const MathFunction& func) const {
+        std::string slot = getSystemName() + "'";
+        std::string text;
+        if (cache && cache->lookup(func, slot, text)) return text;
+        
+        text = exportToFormat(func.derivative());
+        if (cache) cache->store(func, slot, text);
+        return text;
+    }
 };
 
-class MathematicaExporter : public ComputerAlgebraInterface {
-public:
-    std::string exportToFormat(const MathFunction& func) const override {
-        std::string expr = func.toString();
+// Синтаксис цільової системи для InfixExportVisitor
+struct ExportSyntax {
+    enum class NumberStyle { Plain, Mathematica, LaTeX };
+    
+    const char* productOperator;
+    const char* powerOperator;
+    const char* powerClose;
+    bool wrapNegativeExponent;
+    const char* sinOpen;
+    const char* cosOpen;
+    const char* expOpen;
+    const char* lnOpen;
+    const char* callClose;
+    NumberStyle numbers;
+    const char* powerFunction = nullptr;    // якщо задано, степінь пишеться як powerFunction(base, exp)
+};
+
+// Рендер дерева за один лінійний прохід з дописуванням у зовнішній буфер
+class InfixExportVisitor : public ExpressionVisitor {
+protected:
+    std::string& out;
+    const ExportSyntax& syntax;
+    
+    // Дає підкласам змогу підставити ім'я замість піддерева (наприклад, тимчасову змінну CSE)
+    virtual bool substitute(const MathExpression& /*node*/) {
+        return false;
+    }
+    
+    void appendChild(const std::shared_ptr<MathExpression>& child) {
+        if (!substitute(*child)) child->accept(*this);
+    }
+    
+private:    
+    void appendNumber(double value) {
+        char buf[32];
+        auto res = std::to_chars(buf, buf + sizeof(buf), value);
+        std::string text(buf, res.ptr);
         
-        replaceAll(expr, "exp(", "Exp[");
-        replaceAll(expr, "sin(", "Sin[");
-        replaceAll(expr, "cos(", "Cos[");
-        replaceAll(expr, "ln(", "Log[");
-        replaceAll(expr, ")", "]");
-        replaceAll(expr, "^", "^");
+        size_t e = text.find('e');
+        if (e == std::string::npos || syntax.numbers == ExportSyntax::NumberStyle::Plain) {
+            out += text;
+        } else if (syntax.numbers == ExportSyntax::NumberStyle::Mathematica) {
+            out.append(text, 0, e);
+            out += "*^";
+            out.append(text, e + 1, std::string::npos);
+        } else {
+            out.append(text, 0, e);
+            out += " \\cdot 10^{";
+            out.append(text, e + 1, std::string::npos);
+            out += "}";
+        }
+    }
+    
+    void appendCall(const char* open, const std::shared_ptr<MathExpression>& arg) {
+        out += open;
+        appendChild(arg);
+        out += syntax.callClose;
+    }
+    
+public:
+    InfixExportVisitor(std::string& output, const ExportSyntax& exportSyntax)
+        : out(output), syntax(exportSyntax) {}
+    
+    void visit(const Constant& node) override {
+        appendNumber(node.getValue());
+    }
+    
+    void visit(const Variable& /*node*/) override {
+        out += 'x';
+    }
+    
+    void visit(const Sum& node) override {
+        out += '(';
+        appendChild(node.getLeft());
+        out += " + ";
+        appendChild(node.getRight());
+        out += ')';
+    }
+    
+    void visit(const Product& node) override {
+        out += '(';
+        appendChild(node.getLeft());
+        out += syntax.productOperator;
+        appendChild(node.getRight());
+        out += ')';
+    }
+    
+    void visit(const Power& node) override {
+        if (syntax.powerFunction) {
+            out += syntax.powerFunction;
+            appendChild(node.getBase());
+            out += ", ";
+            appendNumber(node.getExponent());
+            out += ')';
+            return;
+        }
         
-        return expr;
+        out += '(';
+        appendChild(node.getBase());
+        out += ')';
+        out += syntax.powerOperator;
+        bool wrap = syntax.wrapNegativeExponent && node.getExponent() < 0;
+        if (wrap) out += '(';
+        appendNumber(node.getExponent());
+        if (wrap) out += ')';
+        out += syntax.powerClose;
     }
     
-    void exportToFile(const MathFunction& func, const std::string& filename) const override {
-        std::ofstream out(filename);
-        if (!out) throw std::runtime_error("Cannot open file");
+    void visit(const Cos& node) override {
+        appendCall(syntax.cosOpen, node.getArgument());
+    }
+    
+    void visit(const Sin& node) override {
+        appendCall(syntax.sinOpen, node.getArgument());
+    }
+    
+    void visit(const Exp& node) override {
+        appendCall(syntax.expOpen, node.getArgument());
+    }
+    
+    void visit(const Ln& node) override {
+        appendCall(syntax.lnOpen, node.getArgument());
+    }
+};
+
+// Ім'я функції, придатне як ідентифікатор у C та Python (f' -> f_)
+inline std::string sanitizeIdentifier(const std::string& name) {
+    std::string id;
+    for (char c : name) {
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        id += ok ? c : '_';
+    }
+    if (id.empty() || (id[0] >= '0' && id[0] <= '9')) id = "f_" + id;
+    return id;
+}
+
+// Пошук спільних підвиразів: структурно однакові піддерева отримують один вузол,
+// а ті, що використовуються більше одного разу, - номер тимчасової змінної
+class CommonSubexpressions : public ExpressionVisitor {
+private:
+    struct Node {
+        const MathExpression* expr;
+        int uses;
+        int temporary;
+    };
+    
+    std::vector<Node> nodes;
+    std::unordered_multimap<size_t, size_t> byHash;
+    std::unordered_map<const MathExpression*, size_t> byAddress;
+    std::shared_ptr<MathExpression> root;
+    int temporaries;
+    
+    void add(const MathExpression& expr) {
+        auto range = byHash.equal_range(expr.structuralHash());
+        for (auto it = range.first; it != range.second; ++it) {
+            if (nodes[it->second].expr->structurallyEquals(expr)) {
+                ++nodes[it->second].uses;
+                byAddress[&expr] = it->second;
+                return;
+            }
+        }
         
+        expr.accept(*this);
+        nodes.push_back({&expr, 1, -1});
+        byHash.emplace(expr.structuralHash(), nodes.size() - 1);
+        byAddress[&expr] = nodes.size() - 1;
+    }
+    
+    static bool isLeaf(const MathExpression& expr) {
+        return dynamic_cast<const Constant*>(&expr) || dynamic_cast<const Variable*>(&expr);
+    }
+    
+public:
+    explicit CommonSubexpressions(const std::shared_ptr<MathExpression>& expression)
+        : root(expression), temporaries(0) {
+        add(*root);
+        // Вузли йдуть у post-order, тож тимчасові змінні нумеруються в порядку залежностей
+        for (auto& node : nodes) {
+            if (node.uses > 1 && !isLeaf(*node.expr)) node.temporary = temporaries++;
+        }
+    }
+    
+    int temporaryCount() const {
+        return temporaries;
+    }
+    
+    int temporaryOf(const MathExpression& expr) const {
+        auto it = byAddress.find(&expr);
+        return it == byAddress.end() ? -1 : nodes[it->second].temporary;
+    }
+    
+    template<typename Func>
+    void forEachTemporary(Func func) const {
+        for (const auto& node : nodes) {
+            if (node.temporary >= 0) func(node.temporary, *node.expr);
+        }
+    }
+    
+    void visit(const Constant& /*node*/) override {}
+    void visit(const Variable& /*node*/) override {}
+    void visit(const Sum& node) override { add(*node.getLeft()); add(*node.getRight()); }
+    void visit(const Product& node) override { add(*node.getLeft()); add(*node.getRight()); }
+    void visit(const Power& node) override { add(*node.getBase()); }
+    void visit(const Cos& node) override { add(*node.getArgument()); }
+    void visit(const Sin& node) override { add(*node.getArgument()); }
+    void visit(const Exp& node) override { add(*node.getArgument()); }
+    void visit(const Ln& node) override { add(*node.getArgument()); }
+};
+
+// Рендер з підстановкою імен тимчасових змінних (prefix + номер) замість спільних піддерев
+class CSEExportVisitor : public InfixExportVisitor {
+private:
+    const CommonSubexpressions& cse;
+    const char* prefix;
+    
+protected:
+    bool substitute(const MathExpression& node) override {
+        int temp = cse.temporaryOf(node);
+        if (temp < 0) return false;
+        out += prefix;
+        out += std::to_string(temp);
+        return true;
+    }
+    
+public:
+    CSEExportVisitor(std::string& output, const ExportSyntax& exportSyntax,
+                     const CommonSubexpressions& subexpressions, const char* tempPrefix)
+        : InfixExportVisitor(output, exportSyntax), cse(subexpressions), prefix(tempPrefix) {}
+};
+
+class MathematicaExporter : public ComputerAlgebraInterface {
+public:
+    void exportToBuffer(const MathFunction& func, std::string& out) const override {
+        static const ExportSyntax syntax{" * ", "^", "", true, "Sin[", "Cos[", "Exp[", "Log[", "]",
+                                         ExportSyntax::NumberStyle::Mathematica};
+        out += func.getName();
+        out += "[x_] := ";
+        InfixExportVisitor visitor(out, syntax);
+        func.getExpression()->accept(visitor);
+    }
+    
+    void writeDocument(const MathFunction& func, std::ostream& out) const override {
+        const std::string& name = func.getName();
         out << "(* Mathematica code *)\n";
-        out << exportToFormat(func) << "\n";
+        out << render(func) << "\n";
         out << "\n(* Derivative *)\n";
-        out << "D[" << exportToFormat(func) << ", x]\n";
+        out << "D[" << name << "[x], x]\n";
         out << "\n(* Plot *)\n";
-        out << "Plot[" << exportToFormat(func) << ", {x, -10, 10}]\n";
+        out << "Plot[" << name << "[x], {x, -10, 10}]\n";
     }
     
     std::string getSystemName() const override {
         return "Mathematica";
     }
-    
-private:
-    void replaceAll(std::string& str, const std::string& from, const std::string& to) const {
-        size_t pos = 0;
-        while ((pos = str.find(from, pos)) != std::string::npos) {
-            str.replace(pos, from.length(), to);
-            pos += to.length();
-        }
-    }
 };
 
+// Symbolic - код SymPy; NumPy - векторизована функція з CSE і, за потреби, бінарна таблиця значень
 class SymPyExporter : public ComputerAlgebraInterface {
 public:
-    std::string exportToFormat(const MathFunction& func) const override {
-        std::string expr = func.toString();
+    enum class Mode { Symbolic, NumPy };
+    
+private:
+    Mode mode;
+    double tabulationStart;
+    double tabulationEnd;
+    int tabulationPoints;
+    
+    void appendNumPyFunction(const MathFunction& func, std::string& out) const {
+        static const ExportSyntax syntax{" * ", "**", "", true, "np.sin(", "np.cos(", "np.exp(", "np.log(", ")",
+                                         ExportSyntax::NumberStyle::Plain};
+        auto expr = func.getExpression()->simplify();
+        CommonSubexpressions cse(expr);
+        CSEExportVisitor visitor(out, syntax, cse, "t");
         
-        replaceAll(expr, "^", "**");
-        replaceAll(expr, "ln(", "log(");
+        out += "def " + sanitizeIdentifier(func.getName()) + "(x):\n";
+        out += "    x = np.asarray(x, dtype=np.float64)\n";
+        cse.forEachTemporary([&](int temp, const MathExpression& sub) {
+            out += "    t" + std::to_string(temp) + " = ";
+            sub.accept(visitor);
+            out += "\n";
+        });
+        out += "    return ";
+        expr->accept(visitor);
+        // Стала функція має повертати масив тієї ж форми, що й x
+        if (asConstant(expr)) out += " + np.zeros_like(x)";
+        out += "\n";
+    }
+    
+    void writeTabulationLoader(std::ostream& out) const {
+        auto number = [](double value) {
+            char buf[32];
+            return std::string(buf, std::to_chars(buf, buf + sizeof(buf), value).ptr);
+        };
+        std::string start = number(tabulationStart);
+        std::string end = number(tabulationEnd);
+        out << "\n# Values written by exportToFile: float64, " << tabulationPoints
+            << " points on [" << start << ", " << end << "]\n";
+        out << "def load_tabulation(path=__file__ + '.bin'):\n";
+        out << "    xs = np.linspace(" << start << ", " << end << ", " << tabulationPoints << ")\n";
+        out << "    ys = np.fromfile(path, dtype=np.float64)\n";
+        out << "    return xs, ys\n";
+    }
+    
+public:
+    explicit SymPyExporter(Mode exportMode = Mode::Symbolic, int points = 0,
+                           double start = -10, double end = 10)
+        : mode(exportMode), tabulationStart(start), tabulationEnd(end), tabulationPoints(points) {
+        if (points == 1) throw std::invalid_argument("Tabulation needs at least two points");
+    }
+    
+    void exportToBuffer(const MathFunction& func, std::string& out) const override {
+        if (mode == Mode::NumPy) {
+            appendNumPyFunction(func, out);
+            return;
+        }
         
-        return expr;
+        static const ExportSyntax syntax{" * ", "**", "", true, "sin(", "cos(", "exp(", "log(", ")",
+                                         ExportSyntax::NumberStyle::Plain};
+        out += "f = ";
+        InfixExportVisitor visitor(out, syntax);
+        func.getExpression()->accept(visitor);
     }
     
-    void exportToFile(const MathFunction& func, const std::string& filename) const override {
-        std::ofstream out(filename);
-        if (!out) throw std::runtime_error("Cannot open file");
+    void writeDocument(const MathFunction& func, std::ostream& out) const override {
+        if (mode == Mode::NumPy) {
+            out << "# Python (NumPy) code\n";
+            out << "import numpy as np\n\n";
+            out << render(func);
+            return;
+        }
         
         out << "# Python (SymPy) code\n";
         out << "from sympy import *\n";
         out << "x = Symbol('x')\n\n";
-        out << "f = " << exportToFormat(func) << "\n";
+        out << render(func) << "\n";
         out << "print('Function:', f)\n";
         out << "print('Derivative:', diff(f, x))\n";
         out << "print('Integral:', integrate(f, x))\n";
@@ -82,76 +487,152 @@ public:
         out << "plot(f, (x, -10, 10))\n";
     }
     
-    std::string getSystemName() const override {
-        return "SymPy (Python)";
+    // У режимі NumPy поруч із .py пишеться filename + ".bin" з табульованими значеннями. load_tabulation
+    // додається лише тут: документи з exportToDocument і пакетного експорту не мають поруч .bin
+    void exportToFile(const MathFunction& func, const std::string& filename) const override {
+        if (mode != Mode::NumPy || tabulationPoints == 0) {
+            ComputerAlgebraInterface::exportToFile(func, filename);
+            return;
+        }
+        {
+            std::ofstream out(filename);
+            if (!out) throw std::runtime_error("Cannot open file");
+            writeDocument(func, out);
+            writeTabulationLoader(out);
+        }
+        func.exportTabulatedData(filename + ".bin", tabulationStart, tabulationEnd,
+                                 tabulationPoints, ExportFormat::Binary);
     }
     
-private:
-    void replaceAll(std::string& str, const std::string& from, const std::string& to) const {
-        size_t pos = 0;
-        while ((pos = str.find(from, pos)) != std::string::npos) {
-            str.replace(pos, from.length(), to);
-            pos += to.length();
-        }
+    std::string getSystemName() const override {
+        return mode == Mode::NumPy ? "NumPy (Python)" : "SymPy (Python)";
     }
 };
 
 class LaTeXExporter : public ComputerAlgebraInterface {
 public:
-    std::string exportToFormat(const MathFunction& func) const override {
-        std::string expr = func.toString();
-        
-        // Базові заміни для LaTeX
-        replaceAll(expr, "*", " \\cdot ");
-        replaceAll(expr, "^", "^{");
-        
-        size_t pos = 0;
-        while ((pos = expr.find("^{", pos)) != std::string::npos) {
-            size_t end = expr.find_first_of(" +*)", pos + 2);
-            if (end != std::string::npos && expr[end - 1] != '}') {
-                expr.insert(end, "}");
-            }
-            pos += 2;
-        }
-        
-        return "$" + expr + "$";
+    void exportToBuffer(const MathFunction& func, std::string& out) const override {
+        static const ExportSyntax syntax{" \\cdot ", "^{", "}", false, "\\sin(", "\\cos(", "\\exp(", "\\ln(", ")",
+                                         ExportSyntax::NumberStyle::LaTeX};
+        out += '$';
+        out += func.getName();
+        out += "(x) = ";
+        InfixExportVisitor visitor(out, syntax);
+        func.getExpression()->accept(visitor);
+        out += '$';
     }
     
-    void exportToFile(const MathFunction& func, const std::string& filename) const override {
-        std::ofstream out(filename);
-        if (!out) throw std::runtime_error("Cannot open file");
-        
+    void writeDocument(const MathFunction& func, std::ostream& out) const override {
         out << "\\documentclass{article}\n";
         out << "\\usepackage{amsmath}\n";
         out << "\\begin{document}\n\n";
-        out << "Function: " << exportToFormat(func) << "\n\n";
-        out << "Derivative: " << exportToFormat(func.derivative()) << "\n\n";
+        out << "Function: " << render(func) << "\n\n";
+        out << "Derivative: " << renderDerivative(func) << "\n\n";
         out << "\\end{document}\n";
     }
     
     std::string getSystemName() const override {
         return "LaTeX";
     }
-    
+};
+
+// Самодостатній C-код: скалярна функція з тимчасовими змінними CSE, опційні похідні
+// name_d1..name_dN і пакетна функція name_batch з циклом, придатним для векторизації
+class CCodeExporter : public ComputerAlgebraInterface {
 private:
-    void replaceAll(std::string& str, const std::string& from, const std::string& to) const {
-        size_t pos = 0;
-        while ((pos = str.find(from, pos)) != std::string::npos) {
-            str.replace(pos, from.length(), to);
-            pos += to.length();
+    int derivativeOrder;
+    
+    static const ExportSyntax& syntax() {
+        static const ExportSyntax cSyntax{" * ", "", "", false, "sin(", "cos(", "exp(", "log(", ")",
+                                          ExportSyntax::NumberStyle::Plain, "pow("};
+        return cSyntax;
+    }
+    
+    static void appendFunction(const std::string& id, const std::shared_ptr<MathExpression>& expr, std::string& out) {
+        CommonSubexpressions cse(expr);
+        CSEExportVisitor visitor(out, syntax(), cse, "t");
+        
+        out += "static inline double " + id + "(double x)\n{\n";
+        cse.forEachTemporary([&](int temp, const MathExpression& sub) {
+            out += "    const double t" + std::to_string(temp) + " = ";
+            sub.accept(visitor);
+            out += ";\n";
+        });
+        out += "    return ";
+        expr->accept(visitor);
+        out += ";\n}\n";
+    }
+    
+    static void appendBatch(const std::string& id, std::string& out) {
+        out += "void " + id + "_batch(const double* restrict xs, double* restrict out, size_t n)\n{\n";
+        out += "    #pragma omp simd\n";
+        out += "    for (size_t i = 0; i < n; ++i) {\n";
+        out += "        out[i] = " + id + "(xs[i]);\n";
+        out += "    }\n}\n";
+    }
+    
+public:
+    explicit CCodeExporter(int derivatives = 0) : derivativeOrder(derivatives) {
+        if (derivatives < 0) throw std::invalid_argument("Derivative order must be non-negative");
+    }
+    
+    void exportToBuffer(const MathFunction& func, std::string& out) const override {
+        appendFunction(sanitizeIdentifier(func.getName()), func.getExpression()->simplify(), out);
+    }
+    
+    void writeDocument(const MathFunction& func, std::ostream& out) const override {
+        std::string id = sanitizeIdentifier(func.getName());
+        std::string code;
+        code += "/* Generated from: " + func.toString() + " */\n";
+        code += "#include <math.h>\n#include <stddef.h>\n\n";
+        code += render(func);
+        code += "\n";
+        appendBatch(id, code);
+        
+        TaylorExpander derivatives(func, derivativeOrder + 1);
+        for (int k = 1; k <= derivativeOrder; ++k) {
+            std::string derivId = id + "_d" + std::to_string(k);
+            code += "\n";
+            appendFunction(derivId, derivatives.getDerivative(k), code);
+            code += "\n";
+            appendBatch(derivId, code);
         }
+        out << code;
+    }
+    
+    std::string getSystemName() const override {
+        return "C";
     }
 };
 
 class CASystemManager {
 private:
     std::vector<std::shared_ptr<ComputerAlgebraInterface>> exporters;
+    std::shared_ptr<ExportCache> cache;
+    
+    template<typename Sink>
+    void renderBatch(const std::vector<MathFunction>& funcs, unsigned threads, Sink sink) const {
+        size_t jobs = funcs.size() * exporters.size();
+        parallelForRange(0, jobs, [&](size_t from, size_t to, unsigned) {
+            for (size_t job = from; job < to; ++job) {
+                size_t index = job / exporters.size();
+                const auto& exporter = *exporters[job % exporters.size()];
+                sink(index, exporter, exporter.exportToDocument(funcs[index]));
+            }
+        }, threads);
+    }
     
 public:
-    CASystemManager() {
+    CASystemManager() : cache(std::make_shared<ExportCache>()) {
         exporters.push_back(std::make_shared<MathematicaExporter>());
         exporters.push_back(std::make_shared<SymPyExporter>());
         exporters.push_back(std::make_shared<LaTeXExporter>());
+        exporters.push_back(std::make_shared<CCodeExporter>());
+        for (auto& exporter : exporters) exporter->setCache(cache);
+    }
+    
+    std::shared_ptr<ExportCache> getCache() const {
+        return cache;
     }
     
     void exportToAll(const MathFunction& func, const std::string& baseFilename) const {
@@ -162,6 +643,30 @@ public:
         }
     }
     
+    // Рендер усіх пар (функція, експортер) на пулі потоків; запис іде через окремий потік вводу-виводу.
+    // Файли мають імена baseFilename_<номер>_<система>. Повертає кількість записаних документів.
+    size_t exportBatch(const std::vector<MathFunction>& funcs, const std::string& baseFilename,
+                       unsigned threads = 0) const {
+        AsyncFileWriter writer;
+        renderBatch(funcs, threads, [&](size_t index, const ComputerAlgebraInterface& exporter, std::string&& doc) {
+            writer.enqueue(baseFilename + "_" + std::to_string(index) + "_" + exporter.getSystemName(), std::move(doc));
+        });
+        writer.close();
+        return funcs.size() * exporters.size();
+    }
+    
+    // Те саме, але всі документи йдуть в один файл-архів, кожен із заголовком секції
+    size_t exportBatchToArchive(const std::vector<MathFunction>& funcs, const std::string& archiveFilename,
+                                unsigned threads = 0) const {
+        AsyncFileWriter writer(archiveFilename);
+        renderBatch(funcs, threads, [&](size_t index, const ComputerAlgebraInterface& exporter, std::string&& doc) {
+            writer.enqueue("=== " + std::to_string(index) + " " + funcs[index].getName() + " " +
+                           exporter.getSystemName() + " ===", std::move(doc));
+        });
+        writer.close();
+        return funcs.size() * exporters.size();
+    }
+    
     void exportTo(const MathFunction& func, const std::string& filename, size_t exporterIndex) const {
         if (exporterIndex >= exporters.size()) {
             throw std::out_of_range("Invalid exporter index");
@@ -0,0 +1,285 @@
+#ifndef CONCURRENTSPARSELIST_H
+#define CONCURRENTSPARSELIST_H
+
+#include "ISparseContainer.h"
+#include <map>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <shared_mutex>
+#include <mutex>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <stdexcept>
+
+// Розріджений список для одночасного запису й читання з кількох потоків.
+// Індекси діляться на блоки по blockSize, блоки циклічно розподіляються між шардами;
+// кожен шард має власну map і reader-writer блокування. get/set блокують лише один шард,
+// операції над усім контейнером (пошук, toString, збереження) тримають спільні блокування всіх шардів.
+template<typename T>
+class ConcurrentSparseList : public ISparseContainer<T> {
+private:
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::map<size_t, T> data;
+    };
+    
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t blockSize;
+    std::atomic<size_t> listSize;
+    T defaultValue;
+    
+    size_t shardIndexOf(size_t index) const {
+        return (index / blockSize) % shards.size();
+    }
+    
+    Shard& shardFor(size_t index) const {
+        return *shards[shardIndexOf(index)];
+    }
+    
+    void growTo(size_t newSize) {
+        size_t current = listSize.load();
+        while (current < newSize && !listSize.compare_exchange_weak(current, newSize)) {
+        }
+    }
+    
+    // Блокування всіх шардів у фіксованому порядку, щоб уникнути взаємних блокувань
+    std::vector<std::shared_lock<std::shared_mutex>> lockAllShared() const {
+        std::vector<std::shared_lock<std::shared_mutex>> locks;
+        locks.reserve(shards.size());
+        for (const auto& shard : shards) locks.emplace_back(shard->mutex);
+        return locks;
+    }
+    
+    std::vector<std::unique_lock<std::shared_mutex>> lockAllUnique() {
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        locks.reserve(shards.size());
+        for (const auto& shard : shards) locks.emplace_back(shard->mutex);
+        return locks;
+    }
+    
+    T getUnlocked(size_t index) const {
+        const Shard& shard = shardFor(index);
+        auto it = shard.data.find(index);
+        return (it != shard.data.end()) ? it->second : defaultValue;
+    }
+    
+public:
+    ConcurrentSparseList(size_t size = 0, const T& defVal = T(), size_t shardCount = 64, size_t block = 1024)
+        : blockSize(block), listSize(size), defaultValue(defVal) {
+        if (shardCount == 0 || block == 0) {
+            throw std::invalid_argument("Shard count and block size must be positive");
+        }
+        for (size_t i = 0; i < shardCount; ++i) {
+            shards.push_back(std::make_unique<Shard>());
+        }
+    }
+    
+    T get(size_t index) const override {
+        if (index >= listSize.load()) {
+            throw std::out_of_range("Index out of range");
+        }
+        const Shard& shard = shardFor(index);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.data.find(index);
+        return (it != shard.data.end()) ? it->second : defaultValue;
+    }
+    
+    // Розмір збільшується під блокуванням шарду: clear() і loadFromFile() скидають його, лише
+    // тримаючи всі шарди, тож збережений елемент не може опинитися за межами size()
+    void set(size_t index, const T& value) override {
+        Shard& shard = shardFor(index);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        growTo(index + 1);
+        if (value == defaultValue) {
+            shard.data.erase(index);
+        } else {
+            shard.data[index] = value;
+        }
+    }
+    
+    // Накопичення value[index] += delta під блокуванням одного шарду, без окремих get()/set()
+    void add(size_t index, const T& delta) {
+        Shard& shard = shardFor(index);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        growTo(index + 1);
+        auto it = shard.data.find(index);
+        T value = ((it != shard.data.end()) ? it->second : defaultValue) + delta;
+        if (value == defaultValue) {
+            if (it != shard.data.end()) shard.data.erase(it);
+        } else if (it != shard.data.end()) {
+            it->second = value;
+        } else {
+            shard.data.emplace(index, value);
+        }
+    }
+    
+    // Пакет розкладається по шардах, і кожен шард блокується лише один раз
+    void setBatch(const std::vector<size_t>& indices, const std::vector<T>& values) override {
+        if (indices.size() != values.size()) {
+            throw std::invalid_argument("Indices and values must have the same length");
+        }
+        if (indices.empty()) return;
+        
+        std::vector<std::vector<size_t>> perShard(shards.size());
+        std::vector<size_t> shardEnd(shards.size(), 0);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            size_t s = shardIndexOf(indices[i]);
+            perShard[s].push_back(i);
+            shardEnd[s] = std::max(shardEnd[s], indices[i] + 1);
+        }
+        
+        // Як і в set(), розмір росте під блокуванням того шарду, куди пишуться елементи
+        for (size_t s = 0; s < shards.size(); ++s) {
+            if (perShard[s].empty()) continue;
+            Shard& shard = *shards[s];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            growTo(shardEnd[s]);
+            for (size_t i : perShard[s]) {
+                if (values[i] == defaultValue) {
+                    shard.data.erase(indices[i]);
+                } else {
+                    shard.data[indices[i]] = values[i];
+                }
+            }
+        }
+    }
+    
+    // Розмір читається вже під блокуваннями, інакше паралельний clear() міг би його зменшити
+    void gatherBatch(const std::vector<size_t>& indices, std::vector<T>& out) const override {
+        out.resize(indices.size());
+        auto locks = lockAllShared();
+        size_t sz = listSize.load();
+        for (size_t i = 0; i < indices.size(); ++i) {
+            if (indices[i] >= sz) throw std::out_of_range("Index out of range");
+            out[i] = getUnlocked(indices[i]);
+        }
+    }
+    
+    int findByValue(const T& value) const override {
+        auto locks = lockAllShared();
+        
+        if (value == defaultValue) {
+            for (size_t i = 0; i < listSize.load(); ++i) {
+                const Shard& shard = shardFor(i);
+                if (shard.data.find(i) == shard.data.end()) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+        
+        // map у кожному шарді впорядкована, тож досить першого збігу в кожному
+        size_t best = listSize.load();
+        for (const auto& shard : shards) {
+            for (const auto& pair : shard->data) {
+                if (pair.first >= best) break;
+                if (pair.second == value) {
+                    best = pair.first;
+                    break;
+                }
+            }
+        }
+        return best < listSize.load() ? static_cast<int>(best) : -1;
+    }
+    
+    int findFirstBy(std::function<bool(const T&)> predicate) const override {
+        auto locks = lockAllShared();
+        for (size_t i = 0; i < listSize.load(); ++i) {
+            if (predicate(getUnlocked(i))) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+    
+    // Знімок збережених елементів робиться під спільними блокуваннями, відвідувач викликається вже без них
+    void forEachStored(std::function<void(size_t, const T&)> visitor) const override {
+        std::vector<std::pair<size_t, T>> entries;
+        {
+            auto locks = lockAllShared();
+            for (const auto& shard : shards) entries.insert(entries.end(), shard->data.begin(), shard->data.end());
+        }
+        std::sort(entries.begin(), entries.end(),
+                  [](const std::pair<size_t, T>& a, const std::pair<size_t, T>& b) { return a.first < b.first; });
+        for (const auto& entry : entries) {
+            visitor(entry.first, entry.second);
+        }
+    }
+    
+    size_t size() const override {
+        return listSize.load();
+    }
+    
+    size_t nonZeroCount() const override {
+        auto locks = lockAllShared();
+        size_t count = 0;
+        for (const auto& shard : shards) count += shard->data.size();
+        return count;
+    }
+    
+    std::string toString() const override {
+        auto locks = lockAllShared();
+        size_t stored = 0;
+        for (const auto& shard : shards) stored += shard->data.size();
+        
+        size_t sz = listSize.load();
+        std::ostringstream oss;
+        oss << "ConcurrentSparseList[size=" << sz << ", stored=" << stored
+            << ", shards=" << shards.size() << "]: [";
+        for (size_t i = 0; i < std::min(sz, size_t(10)); ++i) {
+            if (i > 0) oss << ", ";
+            oss << getUnlocked(i);
+        }
+        if (sz > 10) oss << ", ...";
+        oss << "]";
+        return oss.str();
+    }
+    
+    void clear() override {
+        auto locks = lockAllUnique();
+        for (auto& shard : shards) shard->data.clear();
+        listSize.store(0);
+    }
+    
+    void saveToFile(const std::string& filename) const override {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Cannot open file for writing");
+        
+        auto locks = lockAllShared();
+        std::map<size_t, T> merged;
+        for (const auto& shard : shards) merged.insert(shard->data.begin(), shard->data.end());
+        
+        out << "ConcurrentSparseList\n";
+        out << listSize.load() << "\n";
+        out << merged.size() << "\n";
+        for (const auto& pair : merged) {
+            out << pair.first << " " << pair.second << "\n";
+        }
+    }
+    
+    void loadFromFile(const std::string& filename) override {
+        std::ifstream in(filename);
+        if (!in) throw std::runtime_error("Cannot open file for reading");
+        
+        std::string type;
+        in >> type;
+        if (type != "ConcurrentSparseList") throw std::runtime_error("Invalid file format");
+        
+        size_t sz, count;
+        in >> sz >> count;
+        
+        auto locks = lockAllUnique();
+        for (auto& shard : shards) shard->data.clear();
+        listSize.store(sz);
+        for (size_t i = 0; i < count; ++i) {
+            size_t idx;
+            T val;
+            in >> idx >> val;
+            shardFor(idx).data[idx] = val;
+        }
+    }
+};
+
+#endif
\ No newline at end of file
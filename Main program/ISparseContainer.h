@@ -3,6 +3,32 @@
 
 #include <string>
 #include <functional>
+#include <cstddef>
+#include <vector>
+#include <stdexcept>
+
+// Збережений елемент (індекс, значення), який повертають ітератори розріджених контейнерів.
+// Посилання на значення дійсне, доки контейнер не змінюється.
+template<typename T>
+struct SparseEntry {
+    size_t index;
+    const T& value;
+};
+
+// Пара ітераторів як діапазон для range-for та алгоритмів стандартної бібліотеки
+template<typename Iterator>
+class IteratorRange {
+private:
+    Iterator first;
+    Iterator last;
+    
+public:
+    IteratorRange(Iterator b, Iterator e) : first(b), last(e) {}
+    
+    Iterator begin() const { return first; }
+    Iterator end() const { return last; }
+    bool empty() const { return first == last; }
+};
 
 template<typename T>
 class ISparseContainer {
@@ -15,6 +41,27 @@ public:
     virtual int findByValue(const T& value) const = 0;
     virtual int findFirstBy(std::function<bool(const T&)> predicate) const = 0;
     
+    // Пакетний запис і читання. Реалізація за замовчуванням - поелементні set()/get();
+    // при повторних індексах у setBatch діє останній запис
+    virtual void setBatch(const std::vector<size_t>& indices, const std::vector<T>& values) {
+        if (indices.size() != values.size()) {
+            throw std::invalid_argument("Indices and values must have the same length");
+        }
+        for (size_t i = 0; i < indices.size(); ++i) {
+            set(indices[i], values[i]);
+        }
+    }
+    
+    virtual void gatherBatch(const std::vector<size_t>& indices, std::vector<T>& out) const {
+        out.resize(indices.size());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            out[i] = get(indices[i]);
+        }
+    }
+    
+    // Обхід лише збережених елементів у порядку зростання індексу - O(nnz) замість size() викликів get()
+    virtual void forEachStored(std::function<void(size_t, const T&)> visitor) const = 0;
+    
     virtual size_t size() const = 0;
     virtual size_t nonZeroCount() const = 0;
     virtual std::string toString() const = 0;
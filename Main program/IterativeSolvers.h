@@ -0,0 +1,762 @@
+#ifndef ITERATIVESOLVERS_H
+#define ITERATIVESOLVERS_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "SparseMatrix.h"
+#include "ParallelUtils.h"
+
+// Ітераційні розв'язувачі A x = b над будь-якою SparseMatrix<T>: спряжені градієнти (CG) для
+// симетричних додатно визначених матриць, BiCGSTAB і GMRES(m) з перезапуском для несиметричних.
+// Добуток матриці на вектор іде через multiplyVectorInto (у CSR - паралельно за рядками).
+// Робочі вектори виділяються один раз на розв'язання, а векторні оновлення ітерації злиті
+// зі скалярними добутками, які потрібні одразу після них, тож кожен вектор читається за прохід.
+// Збіжність: ||b - A x|| <= tolerance * ||b||.
+
+struct SolverOptions {
+    double tolerance = 1e-8;        // відносна нев'язка
+    size_t maxIterations = 1000;
+    size_t restart = 30;            // розмір підпростору Крилова в GMRES
+    unsigned threads = 0;           // потоки для SpMV і векторних ядер, 0 - усі апаратні
+    bool recordHistory = true;
+};
+
+enum class SolverStatus { Converged, MaxIterations, Breakdown };
+
+struct SolverResult {
+    SolverStatus status = SolverStatus::MaxIterations;
+    size_t iterations = 0;
+    double residualNorm = 0;                // справжня відносна нев'язка ||b - A x|| / ||b|| наприкінці
+    std::vector<double> residualHistory;    // оцінка відносної нев'язки: [0] - початкова, далі по ітераціях
+    size_t matrixProducts = 0;
+    size_t preconditionerApplications = 0;
+    double seconds = 0;
+    double matrixSeconds = 0;               // частка seconds на SpMV
+    double preconditionerSeconds = 0;       // частка seconds на передобумовлювач
+    
+    bool converged() const { return status == SolverStatus::Converged; }
+    
+    std::string toString() const {
+        static const char* names[] = {"converged", "max iterations", "breakdown"};
+        std::ostringstream oss;
+        oss << names[static_cast<int>(status)] << " after " << iterations << " iterations, residual "
+            << residualNorm << ", " << matrixProducts << " SpMV, " << seconds * 1e3 << " ms (SpMV "
+            << matrixSeconds * 1e3 << " ms, preconditioner " << preconditionerSeconds * 1e3 << " ms)";
+        return oss.str();
+    }
+};
+
+// ---- Злиті векторні ядра ----
+// Довгі вектори діляться між потоками на суцільні частини; часткові суми кожної частини
+// накопичуються в чотирьох незалежних наборах (як у SparseKernels.h) і додаються в порядку частин,
+// тож результат залежить лише від кількості потоків. Скалярні добутки рахуються в double.
+
+constexpr size_t VECTOR_CHUNK = size_t(1) << 16;
+constexpr size_t MAX_VECTOR_WORKERS = 64;
+
+// step(k, sums) обробляє елемент k і додає свої внески до sums[0..Count)
+template<size_t Count, typename Step>
+std::array<double, Count> accumulateRange(size_t from, size_t to, Step& step) {
+    std::array<std::array<double, Count>, 4> lanes{};
+    size_t k = from;
+    for (; k + 4 <= to; k += 4) {
+        step(k, lanes[0].data());
+        step(k + 1, lanes[1].data());
+        step(k + 2, lanes[2].data());
+        step(k + 3, lanes[3].data());
+    }
+    for (; k < to; ++k) step(k, lanes[0].data());
+    
+    std::array<double, Count> sums{};
+    for (size_t c = 0; c < Count; ++c) sums[c] = (lanes[0][c] + lanes[1][c]) + (lanes[2][c] + lanes[3][c]);
+    return sums;
+}
+
+template<size_t Count, typename Step>
+std::array<double, Count> fusedReduce(size_t n, unsigned threads, Step step) {
+    size_t workers = std::min<size_t>(resolveThreadCount(threads), MAX_VECTOR_WORKERS);
+    workers = std::min(workers, std::max<size_t>(1, n / VECTOR_CHUNK));
+    if (workers <= 1) return accumulateRange<Count>(0, n, step);
+    
+    std::array<std::array<double, Count>, MAX_VECTOR_WORKERS> partial;
+    parallelForRange(0, n, [&](size_t from, size_t to, unsigned t) {
+        partial[t] = accumulateRange<Count>(from, to, step);
+    }, static_cast<unsigned>(workers));
+    
+    std::array<double, Count> sums{};
+    for (size_t t = 0; t < workers; ++t) {
+        for (size_t c = 0; c < Count; ++c) sums[c] += partial[t][c];
+    }
+    return sums;
+}
+
+template<typename T>
+double dotProduct(const T* a, const T* b, size_t n, unsigned threads = 0) {
+    return fusedReduce<1>(n, threads, [a, b](size_t k, double* s) {
+        s[0] += static_cast<double>(a[k]) * static_cast<double>(b[k]);
+    })[0];
+}
+
+// r = b - ax; повертає r·r
+template<typename T>
+double residualInto(const T* b, const T* ax, T* r, size_t n, unsigned threads = 0) {
+    return fusedReduce<1>(n, threads, [=](size_t k, double* s) {
+        r[k] = b[k] - ax[k];
+        s[0] += static_cast<double>(r[k]) * static_cast<double>(r[k]);
+    })[0];
+}
+
+// y += alpha * x
+template<typename T>
+void addScaled(T* y, double alpha, const T* x, size_t n, unsigned threads = 0) {
+    T a = static_cast<T>(alpha);
+    fusedReduce<0>(n, threads, [=](size_t k, double*) { y[k] += a * x[k]; });
+}
+
+// w -= h * v; повертає w·other після оновлення (other може збігатися з w)
+template<typename T>
+double subtractScaledDot(T* w, double h, const T* v, const T* other, size_t n, unsigned threads = 0) {
+    T c = static_cast<T>(h);
+    return fusedReduce<1>(n, threads, [=](size_t k, double* s) {
+        w[k] -= c * v[k];
+        s[0] += static_cast<double>(w[k]) * static_cast<double>(other[k]);
+    })[0];
+}
+
+// ---- Передобумовлювачі ----
+
+// Наближення M до A, яке дешево обертається: apply рахує z = M^{-1} r без виділення пам'яті
+template<typename T>
+class Preconditioner {
+public:
+    virtual ~Preconditioner() = default;
+    
+    // z має розмір r і не перекривається з ним
+    virtual void apply(const std::vector<T>& r, std::vector<T>& z) const = 0;
+    virtual std::string name() const = 0;
+};
+
+// Рядки квадратної матриці зі стовпцями за зростанням і позицією діагонального елемента
+template<typename T>
+struct PreconditionerRows {
+    std::vector<size_t> pointers;
+    std::vector<size_t> columns;
+    std::vector<T> values;
+    std::vector<size_t> diagonal;
+    
+    explicit PreconditionerRows(const SparseMatrix<T>& matrix) {
+        size_t n = matrix.getRows();
+        if (matrix.getCols() != n) {
+            throw std::invalid_argument("Preconditioner requires a square matrix");
+        }
+        if (!(matrix.getDefaultValue() == T())) {
+            throw std::invalid_argument("Preconditioner requires a zero default value");
+        }
+        
+        pointers.assign(n + 1, 0);
+        matrix.forEachStored([this](size_t row, size_t, const T&) { ++pointers[row + 1]; });
+        for (size_t i = 0; i < n; ++i) pointers[i + 1] += pointers[i];
+        
+        std::vector<size_t> next(pointers.begin(), pointers.end() - 1);
+        columns.resize(pointers[n]);
+        values.resize(pointers[n]);
+        matrix.forEachStored([&](size_t row, size_t col, const T& value) {
+            size_t pos = next[row]++;
+            columns[pos] = col;
+            values[pos] = value;
+        });
+        
+        // Формати з невпорядкованим обходом (хеш-таблиця) потребують сортування рядків
+        std::vector<std::pair<size_t, T>> scratch;
+        diagonal.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            size_t start = pointers[i], end = pointers[i + 1];
+            if (!std::is_sorted(columns.begin() + start, columns.begin() + end)) {
+                scratch.clear();
+                for (size_t p = start; p < end; ++p) scratch.emplace_back(columns[p], values[p]);
+                std::sort(scratch.begin(), scratch.end(),
+                          [](const std::pair<size_t, T>& a, const std::pair<size_t, T>& b) { return a.first < b.first; });
+                for (size_t p = start; p < end; ++p) {
+                    columns[p] = scratch[p - start].first;
+                    values[p] = scratch[p - start].second;
+                }
+            }
+            
+            size_t d = std::lower_bound(columns.begin() + start, columns.begin() + end, i) - columns.begin();
+            if (d == end || columns[d] != i || values[d] == T()) {
+                throw std::runtime_error("Preconditioner requires a nonzero diagonal, row " + std::to_string(i));
+            }
+            diagonal[i] = d;
+        }
+    }
+    
+    size_t size() const { return diagonal.size(); }
+};
+
+// Якобі: M = diag(A)
+template<typename T>
+class JacobiPreconditioner : public Preconditioner<T> {
+private:
+    std::vector<T> inverseDiagonal;
+    
+public:
+    explicit JacobiPreconditioner(const SparseMatrix<T>& matrix) {
+        if (matrix.getCols() != matrix.getRows()) {
+            throw std::invalid_argument("Preconditioner requires a square matrix");
+        }
+        inverseDiagonal.assign(matrix.getRows(), T());
+        matrix.forEachStored([this](size_t row, size_t col, const T& value) {
+            if (row == col) inverseDiagonal[row] = value;
+        });
+        for (size_t i = 0; i < inverseDiagonal.size(); ++i) {
+            if (inverseDiagonal[i] == T()) {
+                throw std::runtime_error("Preconditioner requires a nonzero diagonal, row " + std::to_string(i));
+            }
+            inverseDiagonal[i] = T(1) / inverseDiagonal[i];
+        }
+    }
+    
+    void apply(const std::vector<T>& r, std::vector<T>& z) const override {
+        for (size_t i = 0; i < inverseDiagonal.size(); ++i) z[i] = inverseDiagonal[i] * r[i];
+    }
+    
+    std::string name() const override { return "Jacobi"; }
+};
+
+// Неповний LU-розклад без заповнення: L і U мають той самий шаблон, що й A (L з одиничною
+// діагоналлю зберігається на місці нижнього трикутника). Розклад - IKJ-варіант Гаусса,
+// в якому оновлюються лише наявні елементи; позиції рядка i шукаються через масив position.
+template<typename T>
+class ILU0Preconditioner : public Preconditioner<T> {
+private:
+    PreconditionerRows<T> factors;
+    std::vector<T> inverseDiagonal;
+    
+public:
+    explicit ILU0Preconditioner(const SparseMatrix<T>& matrix) : factors(matrix) {
+        size_t n = factors.size();
+        const std::vector<size_t>& ptr = factors.pointers;
+        const std::vector<size_t>& col = factors.columns;
+        std::vector<T>& val = factors.values;
+        const size_t NONE = static_cast<size_t>(-1);
+        std::vector<size_t> position(n, NONE);
+        inverseDiagonal.resize(n);
+        
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t p = ptr[i]; p < ptr[i + 1]; ++p) position[col[p]] = p;
+            
+            for (size_t p = ptr[i]; p < factors.diagonal[i]; ++p) {
+                size_t k = col[p];
+                val[p] *= inverseDiagonal[k];
+                for (size_t q = factors.diagonal[k] + 1; q < ptr[k + 1]; ++q) {
+                    size_t target = position[col[q]];
+                    if (target != NONE) val[target] -= val[p] * val[q];
+                }
+            }
+            
+            T pivot = val[factors.diagonal[i]];
+            if (pivot == T()) {
+                throw std::runtime_error("ILU(0) breakdown: zero pivot at row " + std::to_string(i));
+            }
+            inverseDiagonal[i] = T(1) / pivot;
+            for (size_t p = ptr[i]; p < ptr[i + 1]; ++p) position[col[p]] = NONE;
+        }
+    }
+    
+    // L y = r прямим ходом, потім U z = y зворотним; y зберігається прямо в z
+    void apply(const std::vector<T>& r, std::vector<T>& z) const override {
+        const std::vector<size_t>& ptr = factors.pointers;
+        const std::vector<size_t>& col = factors.columns;
+        const std::vector<T>& val = factors.values;
+        size_t n = factors.size();
+        
+        for (size_t i = 0; i < n; ++i) {
+            T sum = r[i];
+            for (size_t p = ptr[i]; p < factors.diagonal[i]; ++p) sum -= val[p] * z[col[p]];
+            z[i] = sum;
+        }
+        for (size_t i = n; i-- > 0;) {
+            T sum = z[i];
+            for (size_t p = factors.diagonal[i] + 1; p < ptr[i + 1]; ++p) sum -= val[p] * z[col[p]];
+            z[i] = sum * inverseDiagonal[i];
+        }
+    }
+    
+    std::string name() const override { return "ILU(0)"; }
+};
+
+// Симетрична послідовна верхня релаксація:
+// M = omega / (2 - omega) * (D / omega + L) (D / omega)^{-1} (D / omega + U), 0 < omega < 2.
+// Для симетричної додатно визначеної A матриця M теж така, тож SSOR підходить для CG.
+// Множник (2 - omega) / omega вноситься в прямий хід, а D / omega між ходами скорочується.
+template<typename T>
+class SSORPreconditioner : public Preconditioner<T> {
+private:
+    PreconditionerRows<T> rows;
+    std::vector<T> scaledInverseDiagonal;   // omega / a_ii
+    T scale;
+    double omega;
+    
+public:
+    explicit SSORPreconditioner(const SparseMatrix<T>& matrix, double relaxation = 1.0)
+        : rows(matrix), omega(relaxation) {
+        if (!(relaxation > 0.0 && relaxation < 2.0)) {
+            throw std::invalid_argument("SSOR relaxation factor must be in (0, 2)");
+        }
+        scale = static_cast<T>((2.0 - relaxation) / relaxation);
+        scaledInverseDiagonal.resize(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            scaledInverseDiagonal[i] = static_cast<T>(relaxation) / rows.values[rows.diagonal[i]];
+        }
+    }
+    
+    void apply(const std::vector<T>& r, std::vector<T>& z) const override {
+        const std::vector<size_t>& ptr = rows.pointers;
+        const std::vector<size_t>& col = rows.columns;
+        const std::vector<T>& val = rows.values;
+        size_t n = rows.size();
+        
+        for (size_t i = 0; i < n; ++i) {
+            T sum = scale * r[i];
+            for (size_t p = ptr[i]; p < rows.diagonal[i]; ++p) sum -= val[p] * z[col[p]];
+            z[i] = sum * scaledInverseDiagonal[i];
+        }
+        for (size_t i = n; i-- > 0;) {
+            T sum = T();
+            for (size_t p = rows.diagonal[i] + 1; p < ptr[i + 1]; ++p) sum += val[p] * z[col[p]];
+            z[i] -= sum * scaledInverseDiagonal[i];
+        }
+    }
+    
+    std::string name() const override {
+        std::ostringstream oss;
+        oss << "SSOR(" << omega << ")";
+        return oss.str();
+    }
+};
+
+// ---- Розв'язувачі ----
+
+// Спільне для всіх розв'язувачів: перевірка розмірів, облік SpMV і передобумовлювача,
+// запис історії нев'язки та підсумкова справжня нев'язка
+template<typename T>
+class KrylovContext {
+    static_assert(std::is_floating_point<T>::value, "Krylov solvers require a floating-point type");
+    
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    const SparseMatrix<T>& matrix;
+    const Preconditioner<T>* preconditioner;
+    const SolverOptions& options;
+    SolverResult& result;
+    Clock::time_point started;
+    double rhsNorm = 0;
+    
+    static double since(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    
+public:
+    KrylovContext(const SparseMatrix<T>& a, const std::vector<T>& b, std::vector<T>& x,
+                  const Preconditioner<T>* m, const SolverOptions& opts, SolverResult& res)
+        : matrix(a), preconditioner(m), options(opts), result(res), started(Clock::now()) {
+        size_t n = a.getRows();
+        if (a.getCols() != n) {
+            throw std::invalid_argument("Iterative solvers require a square matrix");
+        }
+        if (b.size() != n) {
+            throw std::invalid_argument("Right-hand side size must match matrix rows");
+        }
+        if (x.empty()) {
+            x.assign(n, T());
+        } else if (x.size() != n) {
+            throw std::invalid_argument("Initial guess size must match matrix columns");
+        }
+        if (options.recordHistory) result.residualHistory.reserve(std::min<size_t>(options.maxIterations, 100000) + 1);
+        rhsNorm = std::sqrt(dotProduct(b.data(), b.data(), n, options.threads));
+    }
+    
+    size_t size() const { return matrix.getRows(); }
+    unsigned threads() const { return options.threads; }
+    bool preconditioned() const { return preconditioner != nullptr; }
+    bool zeroRightHandSide() const { return rhsNorm == 0; }
+    
+    void multiply(const std::vector<T>& x, std::vector<T>& y) {
+        Clock::time_point start = Clock::now();
+        matrix.multiplyVectorInto(x, y, options.threads);
+        result.matrixSeconds += since(start);
+        ++result.matrixProducts;
+    }
+    
+    void precondition(const std::vector<T>& r, std::vector<T>& z) {
+        Clock::time_point start = Clock::now();
+        preconditioner->apply(r, z);
+        result.preconditionerSeconds += since(start);
+        ++result.preconditionerApplications;
+    }
+    
+    bool withinTolerance(double residual) const {
+        return residual <= options.tolerance * rhsNorm;
+    }
+    
+    // Записує абсолютну нев'язку; true, якщо досягнуто точності або нев'язка вже не скінченна
+    // (тоді статус - Breakdown)
+    bool record(double residual) {
+        if (options.recordHistory) result.residualHistory.push_back(residual / rhsNorm);
+        if (!std::isfinite(residual)) {
+            breakdown();
+            return true;
+        }
+        if (!withinTolerance(residual)) return false;
+        result.status = SolverStatus::Converged;
+        return true;
+    }
+    
+    bool exhausted() const { return result.iterations >= options.maxIterations; }
+    
+    void breakdown() { result.status = SolverStatus::Breakdown; }
+    
+    // Справжня нев'язка b - A x (scratch - будь-який робочий вектор розміру n)
+    SolverResult& finish(const std::vector<T>& b, const std::vector<T>& x, std::vector<T>& scratch) {
+        if (rhsNorm == 0) {
+            result.residualNorm = 0;
+        } else {
+            multiply(x, scratch);
+            double rr = residualInto(b.data(), scratch.data(), scratch.data(), size(), options.threads);
+            result.residualNorm = std::sqrt(rr) / rhsNorm;
+        }
+        result.seconds = since(started);
+        return result;
+    }
+};
+
+// Передобумовлені спряжені градієнти. Одна ітерація: SpMV, передобумовлювач, p·q,
+// злите x += alpha p, r -= alpha q з r·r, r·z і злите p = z + beta p.
+// Без передобумовлювача z збігається з r і не копіюється.
+template<typename T>
+SolverResult conjugateGradient(const SparseMatrix<T>& matrix, const std::vector<T>& b, std::vector<T>& x,
+                               const Preconditioner<T>* preconditioner = nullptr,
+                               const SolverOptions& options = SolverOptions()) {
+    SolverResult result;
+    KrylovContext<T> context(matrix, b, x, preconditioner, options, result);
+    size_t n = context.size();
+    unsigned threads = context.threads();
+    if (context.zeroRightHandSide()) {
+        std::fill(x.begin(), x.end(), T());
+        result.status = SolverStatus::Converged;
+        return context.finish(b, x, x);
+    }
+    
+    std::vector<T> r(n), p(n), q(n), z;
+    context.multiply(x, q);
+    double rr = residualInto(b.data(), q.data(), r.data(), n, threads);
+    if (context.record(std::sqrt(rr))) return context.finish(b, x, q);
+    
+    if (context.preconditioned()) {
+        z.resize(n);
+        context.precondition(r, z);
+    }
+    const std::vector<T>& direction = context.preconditioned() ? z : r;
+    std::copy(direction.begin(), direction.end(), p.begin());
+    double rz = context.preconditioned() ? dotProduct(r.data(), z.data(), n, threads) : rr;
+    
+    while (!context.exhausted()) {
+        context.multiply(p, q);
+        double pq = dotProduct(p.data(), q.data(), n, threads);
+        if (!(pq > 0)) {
+            // Матриця не додатно визначена (або напрямок вироджений)
+            context.breakdown();
+            break;
+        }
+        
+        T alpha = static_cast<T>(rz / pq);
+        T* xs = x.data();
+        T* rs = r.data();
+        const T* ps = p.data();
+        const T* qs = q.data();
+        rr = fusedReduce<1>(n, threads, [=](size_t k, double* s) {
+            xs[k] += alpha * ps[k];
+            rs[k] -= alpha * qs[k];
+            s[0] += static_cast<double>(rs[k]) * static_cast<double>(rs[k]);
+        })[0];
+        ++result.iterations;
+        if (context.record(std::sqrt(rr))) break;
+        
+        double rzNext = rr;
+        if (context.preconditioned()) {
+            context.precondition(r, z);
+            rzNext = dotProduct(r.data(), z.data(), n, threads);
+        }
+        if (rz == 0) {
+            context.breakdown();
+            break;
+        }
+        T beta = static_cast<T>(rzNext / rz);
+        rz = rzNext;
+        
+        const T* zs = direction.data();
+        T* pw = p.data();
+        fusedReduce<0>(n, threads, [=](size_t k, double*) { pw[k] = zs[k] + beta * pw[k]; });
+    }
+    return context.finish(b, x, q);
+}
+
+// BiCGSTAB з правим передобумовленням (нев'язка рахується для самої A, а не M^{-1} A).
+// Два SpMV на ітерацію; оновлення x і r злиті з r·r та r̂·r наступної ітерації, t·s і t·t -
+// в один прохід. Якщо точність досягнута вже на проміжному s, ітерація завершується достроково.
+template<typename T>
+SolverResult biCGSTAB(const SparseMatrix<T>& matrix, const std::vector<T>& b, std::vector<T>& x,
+                      const Preconditioner<T>* preconditioner = nullptr,
+                      const SolverOptions& options = SolverOptions()) {
+    SolverResult result;
+    KrylovContext<T> context(matrix, b, x, preconditioner, options, result);
+    size_t n = context.size();
+    unsigned threads = context.threads();
+    if (context.zeroRightHandSide()) {
+        std::fill(x.begin(), x.end(), T());
+        result.status = SolverStatus::Converged;
+        return context.finish(b, x, x);
+    }
+    
+    std::vector<T> r(n), shadow(n), p(n, T()), v(n, T()), s(n), t(n), pHat, sHat;
+    context.multiply(x, v);
+    double rr = residualInto(b.data(), v.data(), r.data(), n, threads);
+    if (context.record(std::sqrt(rr))) return context.finish(b, x, t);
+    std::copy(r.begin(), r.end(), shadow.begin());
+    std::fill(v.begin(), v.end(), T());
+    if (context.preconditioned()) {
+        pHat.resize(n);
+        sHat.resize(n);
+    }
+    const std::vector<T>& searchP = context.preconditioned() ? pHat : p;
+    const std::vector<T>& searchS = context.preconditioned() ? sHat : s;
+    
+    double rho = 1, alpha = 1, omega = 1;
+    double rhoNext = rr;
+    while (!context.exhausted()) {
+        if (rhoNext == 0 || omega == 0 || !std::isfinite(rhoNext) || !std::isfinite(omega)) {
+            context.breakdown();
+            break;
+        }
+        
+        // p = r + beta (p - omega v)
+        T beta = static_cast<T>((rhoNext / rho) * (alpha / omega));
+        T om = static_cast<T>(omega);
+        {
+            const T* rs = r.data();
+            const T* vs = v.data();
+            T* ps = p.data();
+            fusedReduce<0>(n, threads, [=](size_t k, double*) { ps[k] = rs[k] + beta * (ps[k] - om * vs[k]); });
+        }
+        rho = rhoNext;
+        
+        if (context.preconditioned()) context.precondition(p, pHat);
+        context.multiply(searchP, v);
+        double shadowV = dotProduct(shadow.data(), v.data(), n, threads);
+        alpha = rho / shadowV;
+        if (shadowV == 0 || !std::isfinite(alpha)) {
+            context.breakdown();
+            break;
+        }
+        
+        // s = r - alpha v
+        T al = static_cast<T>(alpha);
+        double ss;
+        {
+            const T* rs = r.data();
+            const T* vs = v.data();
+            T* sw = s.data();
+            ss = fusedReduce<1>(n, threads, [=](size_t k, double* acc) {
+                sw[k] = rs[k] - al * vs[k];
+                acc[0] += static_cast<double>(sw[k]) * static_cast<double>(sw[k]);
+            })[0];
+        }
+        ++result.iterations;
+        if (context.withinTolerance(std::sqrt(ss))) {
+            addScaled(x.data(), alpha, searchP.data(), n, threads);
+            context.record(std::sqrt(ss));
+            break;
+        }
+        
+        if (context.preconditioned()) context.precondition(s, sHat);
+        context.multiply(searchS, t);
+        std::array<double, 2> ts = fusedReduce<2>(n, threads, [&t, &s](size_t k, double* acc) {
+            double tk = static_cast<double>(t[k]);
+            acc[0] += tk * static_cast<double>(s[k]);
+            acc[1] += tk * tk;
+        });
+        if (ts[1] == 0) {
+            // t = 0: s лежить у ядрі A, далі x не покращити
+            addScaled(x.data(), alpha, searchP.data(), n, threads);
+            context.breakdown();
+            break;
+        }
+        omega = ts[0] / ts[1];
+        if (!std::isfinite(omega)) {
+            context.breakdown();
+            break;
+        }
+        
+        // x += alpha p̂ + omega ŝ, r = s - omega t; разом з r·r і r̂·r
+        om = static_cast<T>(omega);
+        std::array<double, 2> sums;
+        {
+            T* xs = x.data();
+            T* rs = r.data();
+            const T* ph = searchP.data();
+            const T* sh = searchS.data();
+            const T* sv = s.data();
+            const T* tv = t.data();
+            const T* hv = shadow.data();
+            sums = fusedReduce<2>(n, threads, [=](size_t k, double* acc) {
+                xs[k] += al * ph[k] + om * sh[k];
+                rs[k] = sv[k] - om * tv[k];
+                double rk = static_cast<double>(rs[k]);
+                acc[0] += rk * rk;
+                acc[1] += static_cast<double>(hv[k]) * rk;
+            });
+        }
+        rhoNext = sums[1];
+        if (context.record(std::sqrt(sums[0]))) break;
+    }
+    return context.finish(b, x, t);
+}
+
+// GMRES(m) з правим передобумовленням: ортогоналізація модифікованим Грамом-Шмідтом, де
+// віднімання проєкції на v_i злите зі скалярним добутком на v_{i+1} (останній - з ||w||^2),
+// верхня матриця Гессенберга зводиться поворотами Гівенса, тож оцінка нев'язки |g[j+1]|
+// доступна без розв'язання на кожній ітерації. Після m ітерацій - перезапуск від справжньої нев'язки.
+template<typename T>
+SolverResult gmres(const SparseMatrix<T>& matrix, const std::vector<T>& b, std::vector<T>& x,
+                   const Preconditioner<T>* preconditioner = nullptr,
+                   const SolverOptions& options = SolverOptions()) {
+    if (options.restart == 0) {
+        throw std::invalid_argument("GMRES restart length must be positive");
+    }
+    SolverResult result;
+    KrylovContext<T> context(matrix, b, x, preconditioner, options, result);
+    size_t n = context.size();
+    unsigned threads = context.threads();
+    if (context.zeroRightHandSide()) {
+        std::fill(x.begin(), x.end(), T());
+        result.status = SolverStatus::Converged;
+        return context.finish(b, x, x);
+    }
+    
+    size_t m = std::min(options.restart, n);
+    std::vector<std::vector<T>> basis(m + 1, std::vector<T>(n));
+    std::vector<T> w(n), z(context.preconditioned() ? n : 0);
+    std::vector<double> hessenberg((m + 1) * m);    // по стовпцях: H(i, j) = hessenberg[j * (m + 1) + i]
+    std::vector<double> cosines(m), sines(m), g(m + 1), y(m);
+    auto H = [&hessenberg, m](size_t i, size_t j) -> double& { return hessenberg[j * (m + 1) + i]; };
+    
+    bool first = true;
+    while (true) {
+        context.multiply(x, w);
+        double beta = std::sqrt(residualInto(b.data(), w.data(), basis[0].data(), n, threads));
+        if (!std::isfinite(beta)) {
+            context.breakdown();
+            break;
+        }
+        if (first ? context.record(beta) : context.withinTolerance(beta)) {
+            result.status = SolverStatus::Converged;
+            break;
+        }
+        first = false;
+        if (context.exhausted()) break;
+        
+        T inverse = static_cast<T>(1.0 / beta);
+        for (T& value : basis[0]) value *= inverse;
+        std::fill(g.begin(), g.end(), 0.0);
+        g[0] = beta;
+        
+        size_t j = 0;
+        bool converged = false, singular = false;
+        while (j < m && !context.exhausted()) {
+            if (context.preconditioned()) {
+                context.precondition(basis[j], z);
+                context.multiply(z, w);
+            } else {
+                context.multiply(basis[j], w);
+            }
+            
+            double h = dotProduct(w.data(), basis[0].data(), n, threads);
+            for (size_t i = 0; i <= j; ++i) {
+                H(i, j) = h;
+                const T* other = i < j ? basis[i + 1].data() : w.data();
+                h = subtractScaledDot(w.data(), h, basis[i].data(), other, n, threads);
+            }
+            double norm = std::sqrt(std::max(h, 0.0));
+            H(j + 1, j) = norm;
+            if (norm != 0) {
+                T scale = static_cast<T>(1.0 / norm);
+                T* next = basis[j + 1].data();
+                const T* ws = w.data();
+                fusedReduce<0>(n, threads, [=](size_t k, double*) { next[k] = ws[k] * scale; });
+            }
+            
+            for (size_t i = 0; i < j; ++i) {
+                double upper = cosines[i] * H(i, j) + sines[i] * H(i + 1, j);
+                H(i + 1, j) = -sines[i] * H(i, j) + cosines[i] * H(i + 1, j);
+                H(i, j) = upper;
+            }
+            double radius = std::hypot(H(j, j), H(j + 1, j));
+            if (radius == 0 || !std::isfinite(radius)) {
+                singular = true;
+                break;
+            }
+            cosines[j] = H(j, j) / radius;
+            sines[j] = H(j + 1, j) / radius;
+            H(j, j) = radius;
+            H(j + 1, j) = 0;
+            g[j + 1] = -sines[j] * g[j];
+            g[j] = cosines[j] * g[j];
+            
+            ++j;
+            ++result.iterations;
+            converged = context.record(std::abs(g[j]));
+            // Щаслива зупинка: підпростір Крилова інваріантний, точний розв'язок уже в ньому
+            if (converged || norm == 0) break;
+        }
+        
+        // H y = g зворотною підстановкою, потім x += M^{-1} (V y)
+        for (size_t i = j; i-- > 0;) {
+            double sum = g[i];
+            for (size_t k = i + 1; k < j; ++k) sum -= H(i, k) * y[k];
+            y[i] = sum / H(i, i);
+        }
+        if (j > 0) {
+            T* ws = w.data();
+            const std::vector<std::vector<T>>& v = basis;
+            const std::vector<double>& coefficients = y;
+            fusedReduce<0>(n, threads, [ws, &v, &coefficients, j](size_t k, double*) {
+                T sum = T();
+                for (size_t i = 0; i < j; ++i) sum += static_cast<T>(coefficients[i]) * v[i][k];
+                ws[k] = sum;
+            });
+            if (context.preconditioned()) {
+                context.precondition(w, z);
+                addScaled(x.data(), 1.0, z.data(), n, threads);
+            } else {
+                addScaled(x.data(), 1.0, w.data(), n, threads);
+            }
+        }
+        
+        if (singular) {
+            context.breakdown();
+            break;
+        }
+        if (converged || context.exhausted()) break;
+    }
+    return context.finish(b, x, w);
+}
+
+#endif
\ No newline at end of file
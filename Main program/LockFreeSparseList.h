@@ -0,0 +1,383 @@
+#ifndef LOCKFREESPARSELIST_H
+#define LOCKFREESPARSELIST_H
+
+#include "ISparseContainer.h"
+#include "SparseKernels.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <cmath>
+#include <sstream>
+#include <fstream>
+#include <stdexcept>
+
+// Розріджений вектор для інтенсивного паралельного set()/add() без блокувань.
+// Зберігання - хеш-таблиця з відкритою адресацією фіксованої місткості: слот захоплюється
+// CAS-ом ключа, значення - std::atomic<T>. Видалення немає: запис значення за замовчуванням
+// лише обнуляє слот. Після завершення запису freeze() перетворює таблицю на відсортовані
+// масиви індексів і значень для швидкої ітерації; заморожений список доступний лише для читання.
+// Таблиця не росте: різних індексів може бути не більше 3/4 місткості (півтора expectedNonZeros),
+// далі set()/add() нового індексу кидає length_error, не доводячи пробування до повного перебору.
+template<typename T>
+class LockFreeSparseList : public ISparseContainer<T> {
+    static_assert(std::is_trivially_copyable<T>::value, "LockFreeSparseList requires a trivially copyable type");
+    
+private:
+    static constexpr size_t EMPTY = std::numeric_limits<size_t>::max();
+    
+    std::unique_ptr<std::atomic<size_t>[]> keys;
+    std::unique_ptr<std::atomic<T>[]> slots;
+    size_t capacity;
+    size_t mask;
+    size_t configuredCapacity;
+    size_t slotLimit;
+    std::atomic<size_t> claimedSlots;
+    std::atomic<size_t> listSize;
+    T defaultValue;
+    
+    bool frozen;
+    std::vector<size_t> frozenIndices;
+    std::vector<T> frozenValues;
+    
+    size_t slotOf(size_t index) const {
+        return (index * 0x9E3779B97F4A7C15ULL) & mask;
+    }
+    
+    // Повертає слот для index, за потреби захоплюючи порожній
+    std::atomic<T>& acquire(size_t index) {
+        if (frozen) throw std::runtime_error("LockFreeSparseList is frozen - use for read-only operations");
+        if (index == EMPTY) throw std::out_of_range("Index out of range");
+        
+        size_t pos = slotOf(index);
+        for (size_t probe = 0; probe < capacity; ++probe) {
+            size_t key = keys[pos].load(std::memory_order_acquire);
+            if (key == index) return claimed(index, pos);
+            if (key == EMPTY) {
+                // Новий ключ: спершу резервується місце в межах допустимого заповнення
+                if (claimedSlots.fetch_add(1, std::memory_order_relaxed) >= slotLimit) {
+                    claimedSlots.fetch_sub(1, std::memory_order_relaxed);
+                    throw std::length_error("LockFreeSparseList is full: more than " + std::to_string(slotLimit) +
+                                            " distinct indices - increase expectedNonZeros");
+                }
+                size_t expected = EMPTY;
+                if (keys[pos].compare_exchange_strong(expected, index, std::memory_order_acq_rel)) {
+                    return claimed(index, pos);
+                }
+                claimedSlots.fetch_sub(1, std::memory_order_relaxed);
+                if (expected == index) return claimed(index, pos);
+            }
+            pos = (pos + 1) & mask;
+        }
+        throw std::length_error("LockFreeSparseList capacity exhausted");
+    }
+    
+    // Розмір зростає лише після того, як слот для index справді отримано
+    std::atomic<T>& claimed(size_t index, size_t pos) {
+        size_t current = listSize.load(std::memory_order_relaxed);
+        while (current <= index && !listSize.compare_exchange_weak(current, index + 1, std::memory_order_relaxed)) {
+        }
+        return slots[pos];
+    }
+    
+    const std::atomic<T>* lookup(size_t index) const {
+        size_t pos = slotOf(index);
+        for (size_t probe = 0; probe < capacity; ++probe) {
+            size_t key = keys[pos].load(std::memory_order_acquire);
+            if (key == index) return &slots[pos];
+            if (key == EMPTY) return nullptr;
+            pos = (pos + 1) & mask;
+        }
+        return nullptr;
+    }
+    
+    void allocateTable(size_t slotCount) {
+        capacity = slotCount;
+        mask = capacity - 1;
+        slotLimit = capacity - capacity / 4;
+        keys.reset(new std::atomic<size_t>[capacity]);
+        slots.reset(new std::atomic<T>[capacity]);
+        resetTable();
+    }
+    
+    static size_t capacityFor(size_t expectedNonZeros) {
+        size_t cap = 16;
+        while (cap < expectedNonZeros * 2) cap <<= 1;
+        return cap;
+    }
+    
+    void resetTable() {
+        claimedSlots.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < capacity; ++i) {
+            keys[i].store(EMPTY, std::memory_order_relaxed);
+            slots[i].store(defaultValue, std::memory_order_relaxed);
+        }
+    }
+    
+    // Відсортовані пари (індекс, значення) без значень за замовчуванням
+    void collect(std::vector<size_t>& indices, std::vector<T>& values) const {
+        if (frozen) {
+            indices = frozenIndices;
+            values = frozenValues;
+            return;
+        }
+        
+        std::vector<std::pair<size_t, T>> entries;
+        for (size_t i = 0; i < capacity; ++i) {
+            size_t key = keys[i].load(std::memory_order_acquire);
+            if (key == EMPTY) continue;
+            T value = slots[i].load(std::memory_order_relaxed);
+            if (!(value == defaultValue)) entries.push_back({key, value});
+        }
+        std::sort(entries.begin(), entries.end(),
+                  [](const std::pair<size_t, T>& a, const std::pair<size_t, T>& b) { return a.first < b.first; });
+        
+        indices.clear();
+        values.clear();
+        indices.reserve(entries.size());
+        values.reserve(entries.size());
+        for (const auto& entry : entries) {
+            indices.push_back(entry.first);
+            values.push_back(entry.second);
+        }
+    }
+    
+    void requireFrozenZeroDefault() const {
+        if (!frozen) throw std::runtime_error("LockFreeSparseList must be frozen first");
+        if (!(defaultValue == T())) throw std::runtime_error("Sparse arithmetic requires a zero default value");
+    }
+    
+public:
+    // expectedNonZeros - скільки різних індексів буде записано; місткість таблиці вдвічі більша.
+    // Це жорстка межа: таблиця не росте, і понад 1.5 * expectedNonZeros різних індексів
+    // set()/add() кидають length_error
+    LockFreeSparseList(size_t size = 0, const T& defVal = T(), size_t expectedNonZeros = 1024)
+        : configuredCapacity(capacityFor(expectedNonZeros)), listSize(size), defaultValue(defVal), frozen(false) {
+        allocateTable(configuredCapacity);
+    }
+    
+    T get(size_t index) const override {
+        if (index >= listSize.load(std::memory_order_relaxed)) {
+            throw std::out_of_range("Index out of range");
+        }
+        
+        if (frozen) {
+            auto it = std::lower_bound(frozenIndices.begin(), frozenIndices.end(), index);
+            if (it != frozenIndices.end() && *it == index) {
+                return frozenValues[it - frozenIndices.begin()];
+            }
+            return defaultValue;
+        }
+        
+        const std::atomic<T>* slot = lookup(index);
+        return slot ? slot->load(std::memory_order_relaxed) : defaultValue;
+    }
+    
+    void set(size_t index, const T& value) override {
+        acquire(index).store(value, std::memory_order_relaxed);
+    }
+    
+    // Атомарне накопичення: value[index] += delta
+    template<typename U = T>
+    typename std::enable_if<std::is_arithmetic<U>::value, void>::type
+    add(size_t index, const T& delta) {
+        std::atomic<T>& slot = acquire(index);
+        if constexpr (std::is_integral<T>::value) {
+            slot.fetch_add(delta, std::memory_order_relaxed);
+        } else {
+            T current = slot.load(std::memory_order_relaxed);
+            while (!slot.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+            }
+        }
+    }
+    
+    // Викликається, коли всі потоки-записувачі завершили роботу
+    void freeze() {
+        if (frozen) return;
+        collect(frozenIndices, frozenValues);
+        frozen = true;
+        allocateTable(1);
+    }
+    
+    bool isFrozen() const {
+        return frozen;
+    }
+    
+    const std::vector<size_t>& getIndices() const {
+        if (!frozen) throw std::runtime_error("LockFreeSparseList must be frozen first");
+        return frozenIndices;
+    }
+    
+    const std::vector<T>& getValues() const {
+        if (!frozen) throw std::runtime_error("LockFreeSparseList must be frozen first");
+        return frozenValues;
+    }
+    
+    // Арифметика над замороженими масивами через ядра SparseKernels.h
+    T dot(const std::vector<T>& dense) const {
+        requireFrozenZeroDefault();
+        if (dense.size() != listSize.load()) {
+            throw std::invalid_argument("Vector size must match list size");
+        }
+        return sparseDenseDot(frozenIndices.data(), frozenValues.data(), frozenIndices.size(), dense.data());
+    }
+    
+    T dot(const LockFreeSparseList<T>& other) const {
+        requireFrozenZeroDefault();
+        other.requireFrozenZeroDefault();
+        return sparseDot(frozenIndices.data(), frozenValues.data(), frozenIndices.size(),
+                         other.frozenIndices.data(), other.frozenValues.data(), other.frozenIndices.size());
+    }
+    
+    void addScaledTo(const T& alpha, std::vector<T>& dense) const {
+        requireFrozenZeroDefault();
+        if (dense.size() != listSize.load()) {
+            throw std::invalid_argument("Vector size must match list size");
+        }
+        sparseAxpy(alpha, frozenIndices.data(), frozenValues.data(), frozenIndices.size(), dense.data());
+    }
+    
+    double norm1() const {
+        requireFrozenZeroDefault();
+        return sumAbs(frozenValues.data(), frozenValues.size());
+    }
+    
+    double norm2() const {
+        requireFrozenZeroDefault();
+        return std::sqrt(sumSquares(frozenValues.data(), frozenValues.size()));
+    }
+    
+    double normInf() const {
+        requireFrozenZeroDefault();
+        return maxAbs(frozenValues.data(), frozenValues.size());
+    }
+    
+    int findByValue(const T& value) const override {
+        size_t sz = listSize.load();
+        if (value == defaultValue) {
+            for (size_t i = 0; i < sz; ++i) {
+                if (get(i) == defaultValue) return static_cast<int>(i);
+            }
+            return -1;
+        }
+        
+        std::vector<size_t> indices;
+        std::vector<T> values;
+        collect(indices, values);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            if (values[i] == value) return static_cast<int>(indices[i]);
+        }
+        return -1;
+    }
+    
+    int findFirstBy(std::function<bool(const T&)> predicate) const override {
+        size_t sz = listSize.load();
+        for (size_t i = 0; i < sz; ++i) {
+            if (predicate(get(i))) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+    
+    void forEachStored(std::function<void(size_t, const T&)> visitor) const override {
+        if (frozen) {
+            for (size_t i = 0; i < frozenIndices.size(); ++i) visitor(frozenIndices[i], frozenValues[i]);
+            return;
+        }
+        
+        std::vector<size_t> indices;
+        std::vector<T> values;
+        collect(indices, values);
+        for (size_t i = 0; i < indices.size(); ++i) visitor(indices[i], values[i]);
+    }
+    
+    size_t size() const override {
+        return listSize.load();
+    }
+    
+    size_t nonZeroCount() const override {
+        if (frozen) return frozenIndices.size();
+        
+        size_t count = 0;
+        for (size_t i = 0; i < capacity; ++i) {
+            if (keys[i].load(std::memory_order_acquire) != EMPTY &&
+                !(slots[i].load(std::memory_order_relaxed) == defaultValue)) {
+                ++count;
+            }
+        }
+        return count;
+    }
+    
+    std::string toString() const override {
+        size_t sz = listSize.load();
+        std::ostringstream oss;
+        oss << "LockFreeSparseList[size=" << sz << ", stored=" << nonZeroCount()
+            << (frozen ? ", frozen" : "") << "]: [";
+        for (size_t i = 0; i < std::min(sz, size_t(10)); ++i) {
+            if (i > 0) oss << ", ";
+            oss << get(i);
+        }
+        if (sz > 10) oss << ", ...";
+        oss << "]";
+        return oss.str();
+    }
+    
+    // Не потокобезпечна; знімає заморожування
+    void clear() override {
+        if (frozen) {
+            frozen = false;
+            frozenIndices.clear();
+            frozenValues.clear();
+            allocateTable(configuredCapacity);
+        } else {
+            resetTable();
+        }
+        listSize.store(0);
+    }
+    
+    void saveToFile(const std::string& filename) const override {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Cannot open file for writing");
+        
+        std::vector<size_t> indices;
+        std::vector<T> values;
+        collect(indices, values);
+        
+        out << "LockFreeSparseList\n";
+        out << listSize.load() << "\n";
+        out << indices.size() << "\n";
+        for (size_t i = 0; i < indices.size(); ++i) {
+            out << indices[i] << " " << values[i] << "\n";
+        }
+    }
+    
+    void loadFromFile(const std::string& filename) override {
+        std::ifstream in(filename);
+        if (!in) throw std::runtime_error("Cannot open file for reading");
+        
+        std::string type;
+        in >> type;
+        if (type != "LockFreeSparseList") throw std::runtime_error("Invalid file format");
+        
+        size_t sz, count;
+        in >> sz >> count;
+        
+        clear();
+        if (count * 2 > capacity) {
+            configuredCapacity = capacityFor(count);
+            allocateTable(configuredCapacity);
+        }
+        listSize.store(sz);
+        for (size_t i = 0; i < count; ++i) {
+            size_t idx;
+            T val;
+            in >> idx >> val;
+            set(idx, val);
+        }
+    }
+};
+
+#endif
\ No newline at end of file
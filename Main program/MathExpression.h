@@ -7,18 +7,77 @@
 #include <sstream>
 #include <map>
 #include <vector>
+#include <functional>
 
+class Constant;
+class Variable;
+class Sum;
+class Product;
+class Power;
 class Cos;
 class Sin;
+class Exp;
+class Ln;
+
+// Обхід дерева виразу без dynamic_cast: кожен вузол викликає відповідний visit
+class ExpressionVisitor {
+public:
+    virtual ~ExpressionVisitor() = default;
+    
+    virtual void visit(const Constant& node) = 0;
+    virtual void visit(const Variable& node) = 0;
+    virtual void visit(const Sum& node) = 0;
+    virtual void visit(const Product& node) = 0;
+    virtual void visit(const Power& node) = 0;
+    virtual void visit(const Cos& node) = 0;
+    virtual void visit(const Sin& node) = 0;
+    virtual void visit(const Exp& node) = 0;
+    virtual void visit(const Ln& node) = 0;
+};
 
 class MathExpression {
+protected:
+    // Структурний хеш рахується в конструкторі з хешів дочірніх вузлів, тому доступ до нього O(1)
+    size_t hashValue = 0;
+    
+    static size_t combineHash(size_t seed, size_t value) {
+        return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+    
 public:
     virtual ~MathExpression() = default;
     
+    size_t structuralHash() const {
+        return hashValue;
+    }
+    
+    virtual bool structurallyEquals(const MathExpression& other) const = 0;
+    
     virtual double evaluate(double x) const = 0;
     virtual std::string toString() const = 0;
     virtual std::shared_ptr<MathExpression> derivative() const = 0;
     virtual std::shared_ptr<MathExpression> clone() const = 0;
+    virtual void accept(ExpressionVisitor& visitor) const = 0;
+    
+    // Згортання констант і нейтральних елементів (0 + e, 1 * e, e^1 ...)
+    virtual std::shared_ptr<MathExpression> simplify() const {
+        return clone();
+    }
+    
+    // Якщо вираз має вигляд slope * x + intercept, повертає true і коефіцієнти
+    virtual bool asLinear(double& /*slope*/, double& /*intercept*/) const {
+        return false;
+    }
+    
+    // За замовчуванням n разів диференціює символьно; підкласи з відомою замкненою формою перевизначають
+    virtual std::shared_ptr<MathExpression> nthDerivative(int n) const {
+        if (n == 0) return clone();
+        auto result = derivative();
+        for (int i = 1; i < n; ++i) {
+            result = result->derivative();
+        }
+        return result;
+    }
 };
 
 class Constant : public MathExpression {
@@ -26,7 +85,13 @@ private:
     double value;
     
 public:
-    Constant(double v) : value(v) {}
+    Constant(double v) : value(v) {
+        hashValue = combineHash(1, std::hash<double>()(v));
+    }
+    
+    double getValue() const {
+        return value;
+    }
     
     double evaluate(double x) const override {
         return value;
@@ -45,10 +110,37 @@ public:
     std::shared_ptr<MathExpression> clone() const override {
         return std::make_shared<Constant>(value);
     }
+    
+    void accept(ExpressionVisitor& visitor) const override {
+        visitor.visit(*this);
+    }
+    
+    bool structurallyEquals(const MathExpression& other) const override {
+        auto o = dynamic_cast<const Constant*>(&other);
+        return o && o->value == value;
+    }
+    
+    bool asLinear(double& slope, double& intercept) const override {
+        slope = 0;
+        intercept = value;
+        return true;
+    }
+    
+    std::shared_ptr<MathExpression> nthDerivative(int n) const override {
+        return n == 0 ? clone() : std::make_shared<Constant>(0);
+    }
 };
 
+inline const Constant* asConstant(const std::shared_ptr<MathExpression>& expr) {
+    return dynamic_cast<const Constant*>(expr.get());
+}
+
 class Variable : public MathExpression {
 public:
+    Variable() {
+        hashValue = combineHash(2, 0);
+    }
+    
     double evaluate(double x) const override {
         return x;
     }
@@ -64,6 +156,25 @@ public:
     std::shared_ptr<MathExpression> clone() const override {
         return std::make_shared<Variable>();
     }
+    
+    void accept(ExpressionVisitor& visitor) const override {
+        visitor.visit(*this);
+    }
+    
+    bool structurallyEquals(const MathExpression& other) const override {
+        return dynamic_cast<const Variable*>(&other) != nullptr;
+    }
+    
+    bool asLinear(double& slope, double& intercept) const override {
+        slope = 1;
+        intercept = 0;
+        return true;
+    }
+    
+    std::shared_ptr<MathExpression> nthDerivative(int n) const override {
+        if (n == 0) return clone();
+        return std::make_shared<Constant>(n == 1 ? 1 : 0);
+    }
 };
 
 class Sum : public MathExpression {
@@ -73,7 +184,17 @@ private:
     
 public:
     Sum(std::shared_ptr<MathExpression> l, std::shared_ptr<MathExpression> r)
-        : left(l), right(r) {}
+        : left(l), right(r) {
+        hashValue = combineHash(combineHash(3, left->structuralHash()), right->structuralHash());
+    }
+    
+    const std::shared_ptr<MathExpression>& getLeft() const {
+        return left;
+    }
+    
+    const std::shared_ptr<MathExpression>& getRight() const {
+        return right;
+    }
     
     double evaluate(double x) const override {
         return left->evaluate(x) + right->evaluate(x);
@@ -90,6 +211,41 @@ public:
     std::shared_ptr<MathExpression> clone() const override {
         return std::make_shared<Sum>(left->clone(), right->clone());
     }
+    
+    void accept(ExpressionVisitor& visitor) const override {
+        visitor.visit(*this);
+    }
+    
+    bool structurallyEquals(const MathExpression& other) const override {
+        auto o = dynamic_cast<const Sum*>(&other);
+        return o && o->hashValue == hashValue &&
+               left->structurallyEquals(*o->left) && right->structurallyEquals(*o->right);
+    }
+    
+    std::shared_ptr<MathExpression> simplify() const override {
+        auto l = left->simplify();
+        auto r = right->simplify();
+        const Constant* lc = asConstant(l);
+        const Constant* rc = asConstant(r);
+        
+        if (lc && rc) return std::make_shared<Constant>(lc->getValue() + rc->getValue());
+        if (lc && lc->getValue() == 0) return r;
+        if (rc && rc->getValue() == 0) return l;
+        return std::make_shared<Sum>(l, r);
+    }
+    
+    bool asLinear(double& slope, double& intercept) const override {
+        double a1, b1, a2, b2;
+        if (!left->asLinear(a1, b1) || !right->asLinear(a2, b2)) return false;
+        slope = a1 + a2;
+        intercept = b1 + b2;
+        return true;
+    }
+    
+    std::shared_ptr<MathExpression> nthDerivative(int n) const override {
+        if (n == 0) return clone();
+        return std::make_shared<Sum>(left->nthDerivative(n), right->nthDerivative(n));
+    }
 };
 
 class Product : public MathExpression {
@@ -99,7 +255,17 @@ private:
     
 public:
     Product(std::shared_ptr<MathExpression> l, std::shared_ptr<MathExpression> r)
-        : left(l), right(r) {}
+        : left(l), right(r) {
+        hashValue = combineHash(combineHash(4, left->structuralHash()), right->structuralHash());
+    }
+    
+    const std::shared_ptr<MathExpression>& getLeft() const {
+        return left;
+    }
+    
+    const std::shared_ptr<MathExpression>& getRight() const {
+        return right;
+    }
     
     double evaluate(double x) const override {
         return left->evaluate(x) * right->evaluate(x);
@@ -118,6 +284,69 @@ public:
     std::shared_ptr<MathExpression> clone() const override {
         return std::make_shared<Product>(left->clone(), right->clone());
     }
+    
+    void accept(ExpressionVisitor& visitor) const override {
+        visitor.visit(*this);
+    }
+    
+    bool structurallyEquals(const MathExpression& other) const override {
+        auto o = dynamic_cast<const Product*>(&other);
+        return o && o->hashValue == hashValue &&
+               left->structurallyEquals(*o->left) && right->structurallyEquals(*o->right);
+    }
+    
+    std::shared_ptr<MathExpression> simplify() const override {
+        auto l = left->simplify();
+        auto r = right->simplify();
+        const Constant* lc = asConstant(l);
+        const Constant* rc = asConstant(r);
+        
+        if (lc && rc) return std::make_shared<Constant>(lc->getValue() * rc->getValue());
+        if (rc) {
+            std::swap(l, r);
+            std::swap(lc, rc);
+        }
+        if (!lc) return std::make_shared<Product>(l, r);
+        
+        double c = lc->getValue();
+        if (c == 0) return std::make_shared<Constant>(0);
+        if (c == 1) return r;
+        
+        // c1 * (c2 * e)  ->  (c1 * c2) * e
+        auto inner = std::dynamic_pointer_cast<Product>(r);
+        if (inner) {
+            if (const Constant* ic = asConstant(inner->left)) {
+                return std::make_shared<Product>(std::make_shared<Constant>(c * ic->getValue()), inner->right);
+            }
+            if (const Constant* ic = asConstant(inner->right)) {
+                return std::make_shared<Product>(std::make_shared<Constant>(c * ic->getValue()), inner->left);
+            }
+        }
+        return std::make_shared<Product>(l, r);
+    }
+    
+    bool asLinear(double& slope, double& intercept) const override {
+        double a1, b1, a2, b2;
+        if (!left->asLinear(a1, b1) || !right->asLinear(a2, b2)) return false;
+        if (a1 != 0 && a2 != 0) return false;
+        slope = a1 * b2 + a2 * b1;
+        intercept = b1 * b2;
+        return true;
+    }
+    
+    std::shared_ptr<MathExpression> nthDerivative(int n) const override {
+        if (n == 0) return clone();
+        
+        // Сталий множник виноситься за похідну
+        double slope, intercept;
+        if (left->asLinear(slope, intercept) && slope == 0) {
+            return std::make_shared<Product>(std::make_shared<Constant>(intercept), right->nthDerivative(n));
+        }
+        if (right->asLinear(slope, intercept) && slope == 0) {
+            return std::make_shared<Product>(left->nthDerivative(n), std::make_shared<Constant>(intercept));
+        }
+        return MathExpression::nthDerivative(n);
+    }
 };
 
 class Power : public MathExpression {
@@ -127,7 +356,17 @@ private:
     
 public:
     Power(std::shared_ptr<MathExpression> b, double exp)
-        : base(b), exponent(exp) {}
+        : base(b), exponent(exp) {
+        hashValue = combineHash(combineHash(5, base->structuralHash()), std::hash<double>()(exponent));
+    }
+    
+    const std::shared_ptr<MathExpression>& getBase() const {
+        return base;
+    }
+    
+    double getExponent() const {
+        return exponent;
+    }
     
     double evaluate(double x) const override {
         return std::pow(base->evaluate(x), exponent);
@@ -149,6 +388,53 @@ public:
     std::shared_ptr<MathExpression> clone() const override {
         return std::make_shared<Power>(base->clone(), exponent);
     }
+    
+    void accept(ExpressionVisitor& visitor) const override {
+        visitor.visit(*this);
+    }
+    
+    bool structurallyEquals(const MathExpression& other) const override {
+        auto o = dynamic_cast<const Power*>(&other);
+        return o && o->hashValue == hashValue && o->exponent == exponent && base->structurallyEquals(*o->base);
+    }
+    
+    std::shared_ptr<MathExpression> simplify() const override {
+        if (exponent == 0) return std::make_shared<Constant>(1);
+        
+        auto b = base->simplify();
+        if (const Constant* bc = asConstant(b)) {
+            return std::make_shared<Constant>(std::pow(bc->getValue(), exponent));
+        }
+        if (exponent == 1) return b;
+        return std::make_shared<Power>(b, exponent);
+    }
+    
+    bool asLinear(double& slope, double& intercept) const override {
+        if (exponent == 0) {
+            slope = 0;
+            intercept = 1;
+            return true;
+        }
+        return exponent == 1 && base->asLinear(slope, intercept);
+    }
+    
+    // (a*x + b)^k  ->  k(k-1)...(k-n+1) * a^n * (a*x + b)^(k-n)
+    std::shared_ptr<MathExpression> nthDerivative(int n) const override {
+        if (n == 0) return clone();
+        
+        double a, b;
+        if (!base->asLinear(a, b)) return MathExpression::nthDerivative(n);
+        
+        double coef = 1.0;
+        for (int i = 0; i < n; ++i) {
+            coef *= (exponent - i) * a;
+        }
+        if (coef == 0) return std::make_shared<Constant>(0);
+        if (exponent - n == 0) return std::make_shared<Constant>(coef);
+        
+        return std::make_shared<Product>(std::make_shared<Constant>(coef),
+                                         std::make_shared<Power>(base->clone(), exponent - n));
+    }
 };
 
 class Cos : public MathExpression {
@@ -156,7 +442,13 @@ private:
     std::shared_ptr<MathExpression> arg;
     
 public:
-    Cos(std::shared_ptr<MathExpression> a) : arg(a) {}
+    Cos(std::shared_ptr<MathExpression> a) : arg(a) {
+        hashValue = combineHash(6, arg->structuralHash());
+    }
+    
+    const std::shared_ptr<MathExpression>& getArgument() const {
+        return arg;
+    }
     
     double evaluate(double x) const override {
         return std::cos(arg->evaluate(x));
@@ -171,6 +463,25 @@ public:
     std::shared_ptr<MathExpression> clone() const override {
         return std::make_shared<Cos>(arg->clone());
     }
+    
+    void accept(ExpressionVisitor& visitor) const override {
+        visitor.visit(*this);
+    }
+    
+    bool structurallyEquals(const MathExpression& other) const override {
+        auto o = dynamic_cast<const Cos*>(&other);
+        return o && o->hashValue == hashValue && arg->structurallyEquals(*o->arg);
+    }
+    
+    std::shared_ptr<MathExpression> simplify() const override {
+        auto a = arg->simplify();
+        if (const Constant* ac = asConstant(a)) {
+            return std::make_shared<Constant>(std::cos(ac->getValue()));
+        }
+        return std::make_shared<Cos>(a);
+    }
+    
+    std::shared_ptr<MathExpression> nthDerivative(int n) const override;
 };
 
 class Sin : public MathExpression {
@@ -178,7 +489,13 @@ private:
     std::shared_ptr<MathExpression> arg;
     
 public:
-    Sin(std::shared_ptr<MathExpression> a) : arg(a) {}
+    Sin(std::shared_ptr<MathExpression> a) : arg(a) {
+        hashValue = combineHash(7, arg->structuralHash());
+    }
+    
+    const std::shared_ptr<MathExpression>& getArgument() const {
+        return arg;
+    }
     
     double evaluate(double x) const override {
         return std::sin(arg->evaluate(x));
@@ -196,6 +513,25 @@ public:
     std::shared_ptr<MathExpression> clone() const override {
         return std::make_shared<Sin>(arg->clone());
     }
+    
+    void accept(ExpressionVisitor& visitor) const override {
+        visitor.visit(*this);
+    }
+    
+    bool structurallyEquals(const MathExpression& other) const override {
+        auto o = dynamic_cast<const Sin*>(&other);
+        return o && o->hashValue == hashValue && arg->structurallyEquals(*o->arg);
+    }
+    
+    std::shared_ptr<MathExpression> simplify() const override {
+        auto a = arg->simplify();
+        if (const Constant* ac = asConstant(a)) {
+            return std::make_shared<Constant>(std::sin(ac->getValue()));
+        }
+        return std::make_shared<Sin>(a);
+    }
+    
+    std::shared_ptr<MathExpression> nthDerivative(int n) const override;
 };
 
 // Реалізація похідної косинуса (після оголошення Sin)
@@ -206,12 +542,47 @@ inline std::shared_ptr<MathExpression> Cos::derivative() const {
     return std::make_shared<Product>(prod, arg->derivative());
 }
 
+// n-та похідна sin/cos від лінійного аргументу: a^n * (±sin | ±cos)(a*x + b), період 4
+inline std::shared_ptr<MathExpression> trigNthDerivative(const std::shared_ptr<MathExpression>& arg,
+                                                         double slope, int n, int phase) {
+    int k = (phase + n) % 4;
+    double coef = std::pow(slope, n) * (k >= 2 ? -1.0 : 1.0);
+    if (coef == 0) return std::make_shared<Constant>(0);
+    
+    std::shared_ptr<MathExpression> trig;
+    if (k % 2 == 0) {
+        trig = std::make_shared<Sin>(arg->clone());
+    } else {
+        trig = std::make_shared<Cos>(arg->clone());
+    }
+    if (coef == 1) return trig;
+    return std::make_shared<Product>(std::make_shared<Constant>(coef), trig);
+}
+
+inline std::shared_ptr<MathExpression> Sin::nthDerivative(int n) const {
+    double a, b;
+    if (n == 0 || !arg->asLinear(a, b)) return MathExpression::nthDerivative(n);
+    return trigNthDerivative(arg, a, n, 0);
+}
+
+inline std::shared_ptr<MathExpression> Cos::nthDerivative(int n) const {
+    double a, b;
+    if (n == 0 || !arg->asLinear(a, b)) return MathExpression::nthDerivative(n);
+    return trigNthDerivative(arg, a, n, 1);
+}
+
 class Exp : public MathExpression {
 private:
     std::shared_ptr<MathExpression> arg;
     
 public:
-    Exp(std::shared_ptr<MathExpression> a) : arg(a) {}
+    Exp(std::shared_ptr<MathExpression> a) : arg(a) {
+        hashValue = combineHash(8, arg->structuralHash());
+    }
+    
+    const std::shared_ptr<MathExpression>& getArgument() const {
+        return arg;
+    }
     
     double evaluate(double x) const override {
         return std::exp(arg->evaluate(x));
@@ -229,6 +600,32 @@ public:
     std::shared_ptr<MathExpression> clone() const override {
         return std::make_shared<Exp>(arg->clone());
     }
+    
+    void accept(ExpressionVisitor& visitor) const override {
+        visitor.visit(*this);
+    }
+    
+    bool structurallyEquals(const MathExpression& other) const override {
+        auto o = dynamic_cast<const Exp*>(&other);
+        return o && o->hashValue == hashValue && arg->structurallyEquals(*o->arg);
+    }
+    
+    std::shared_ptr<MathExpression> simplify() const override {
+        auto a = arg->simplify();
+        if (const Constant* ac = asConstant(a)) {
+            return std::make_shared<Constant>(std::exp(ac->getValue()));
+        }
+        return std::make_shared<Exp>(a);
+    }
+    
+    std::shared_ptr<MathExpression> nthDerivative(int n) const override {
+        double a, b;
+        if (n == 0 || !arg->asLinear(a, b)) return MathExpression::nthDerivative(n);
+        
+        double coef = std::pow(a, n);
+        if (coef == 0) return std::make_shared<Constant>(0);
+        return std::make_shared<Product>(std::make_shared<Constant>(coef), std::make_shared<Exp>(arg->clone()));
+    }
 };
 
 class Ln : public MathExpression {
@@ -236,7 +633,13 @@ private:
     std::shared_ptr<MathExpression> arg;
     
 public:
-    Ln(std::shared_ptr<MathExpression> a) : arg(a) {}
+    Ln(std::shared_ptr<MathExpression> a) : arg(a) {
+        hashValue = combineHash(9, arg->structuralHash());
+    }
+    
+    const std::shared_ptr<MathExpression>& getArgument() const {
+        return arg;
+    }
     
     double evaluate(double x) const override {
         return std::log(arg->evaluate(x));
@@ -254,6 +657,37 @@ public:
     std::shared_ptr<MathExpression> clone() const override {
         return std::make_shared<Ln>(arg->clone());
     }
+    
+    void accept(ExpressionVisitor& visitor) const override {
+        visitor.visit(*this);
+    }
+    
+    bool structurallyEquals(const MathExpression& other) const override {
+        auto o = dynamic_cast<const Ln*>(&other);
+        return o && o->hashValue == hashValue && arg->structurallyEquals(*o->arg);
+    }
+    
+    std::shared_ptr<MathExpression> simplify() const override {
+        auto a = arg->simplify();
+        if (const Constant* ac = asConstant(a)) {
+            return std::make_shared<Constant>(std::log(ac->getValue()));
+        }
+        return std::make_shared<Ln>(a);
+    }
+    
+    // ln(a*x + b)  ->  (-1)^(n-1) * (n-1)! * a^n * (a*x + b)^(-n)
+    std::shared_ptr<MathExpression> nthDerivative(int n) const override {
+        double a, b;
+        if (n == 0 || !arg->asLinear(a, b)) return MathExpression::nthDerivative(n);
+        
+        double coef = (n % 2 == 1) ? 1.0 : -1.0;
+        for (int i = 1; i < n; ++i) coef *= i;
+        coef *= std::pow(a, n);
+        if (coef == 0) return std::make_shared<Constant>(0);
+        
+        return std::make_shared<Product>(std::make_shared<Constant>(coef),
+                                         std::make_shared<Power>(arg->clone(), -n));
+    }
 };
 
 #endif
\ No newline at end of file
@@ -4,12 +4,70 @@
 #include "MathExpression.h"
 #include <vector>
 #include <fstream>
+#include <algorithm>
+#include "BufferedWriter.h"
+#include "ParallelUtils.h"
 
 class MathFunction {
 private:
     std::shared_ptr<MathExpression> expression;
     std::string name;
     
+    double bracketedNewton(const MathExpression& deriv, double a, double fa, double b, double fb,
+                           double tolerance, int maxIterations) const {
+        if (fa == 0) return a;
+        if (fb == 0) return b;
+        if ((fa < 0) == (fb < 0)) {
+            throw std::invalid_argument("Function must change sign on the bracket");
+        }
+        
+        double lo = (fa < 0) ? a : b;
+        double hi = (fa < 0) ? b : a;
+        double x = 0.5 * (a + b);
+        double dxOld = std::abs(b - a);
+        double dx = dxOld;
+        double fx = evaluate(x);
+        double dfx = deriv.evaluate(x);
+        
+        for (int i = 0; i < maxIterations; ++i) {
+            bool outside = ((x - hi) * dfx - fx) * ((x - lo) * dfx - fx) > 0;
+            bool slow = std::abs(2.0 * fx) > std::abs(dxOld * dfx);
+            
+            if (outside || slow || !std::isfinite(dfx)) {
+                dxOld = dx;
+                dx = 0.5 * (hi - lo);
+                x = lo + dx;
+                if (x == lo) return x;
+            } else {
+                dxOld = dx;
+                dx = fx / dfx;
+                double prev = x;
+                x -= dx;
+                if (x == prev) return x;
+            }
+            
+            if (std::abs(dx) < tolerance) return x;
+            
+            fx = evaluate(x);
+            dfx = deriv.evaluate(x);
+            if (fx == 0) return x;
+            if (fx < 0) lo = x; else hi = x;
+        }
+        
+        throw std::runtime_error("Root finding did not converge");
+    }
+    
+    static std::vector<double> uniqueRoots(std::vector<double> roots, double tolerance) {
+        std::sort(roots.begin(), roots.end());
+        std::vector<double> result;
+        for (double r : roots) {
+            if (result.empty() || std::abs(r - result.back()) > tolerance) {
+                result.push_back(r);
+            }
+        }
+        return result;
+    }
+    
 public:
     MathFunction(std::shared_ptr<MathExpression> expr, const std::string& n = "f")
         : expression(expr), name(n) {}
@@ -18,6 +76,14 @@ public:
         return expression->evaluate(x);
     }
     
+    std::shared_ptr<MathExpression> getExpression() const {
+        return expression;
+    }
+    
+    const std::string& getName() const {
+        return name;
+    }
+    
     std::string toString() const {
         return name + "(x) = " + expression->toString();
     }
@@ -30,10 +96,7 @@ public:
         if (n < 0) throw std::invalid_argument("Derivative order must be non-negative");
         if (n == 0) return MathFunction(expression->clone(), name);
         
-        auto result = expression->derivative();
-        for (int i = 1; i < n; ++i) {
-            result = result->derivative();
-        }
+        auto result = expression->nthDerivative(n);
         
         std::string newName = name;
         for (int i = 0; i < n; ++i) newName += "'";
@@ -58,23 +121,7 @@ public:
         return evaluate(point + epsilon);
     }
     
-    std::vector<double> taylorSeries(double point, int terms) const {
-        std::vector<double> coefficients;
-        MathFunction current(expression->clone(), name);
-        double factorial = 1.0;
-        
-        for (int i = 0; i < terms; ++i) {
-            if (i > 0) factorial *= i;
-            double coef = current.evaluate(point) / factorial;
-            coefficients.push_back(coef);
-            
-            if (i < terms - 1) {
-                current = current.derivative();
-            }
-        }
-        
-        return coefficients;
-    }
+    std::vector<double> taylorSeries(double point, int terms) const;
     
     double seriesSum(int start, int end, std::function<double(int)> termFunction) const {
         double sum = 0.0;
@@ -108,6 +155,89 @@ public:
         throw std::runtime_error("Root finding did not converge");
     }
     
+    // Ньютон, захищений бісекцією: крок, що виходить за межі [a, b] або збігається повільно, замінюється бісекцією
+    double findRootInBracket(double a, double b, double tolerance = 1e-12, int maxIterations = 200) const {
+        auto deriv = derivative();
+        return bracketedNewton(*deriv.expression, a, evaluate(a), b, evaluate(b), tolerance, maxIterations);
+    }
+    
+    // Ньютон з кількох початкових наближень; повертає відсортовані унікальні знайдені корені
+    std::vector<double> findRoots(const std::vector<double>& initialGuesses, double tolerance = 1e-10,
+                                  int maxIterations = 100, unsigned threads = 0) const {
+        auto deriv = derivative();
+        std::vector<double> found(initialGuesses.size(), std::nan(""));
+        
+        parallelForRange(0, initialGuesses.size(), [&](size_t from, size_t to, unsigned) {
+            for (size_t g = from; g < to; ++g) {
+                double x = initialGuesses[g];
+                for (int i = 0; i < maxIterations; ++i) {
+                    double dfx = deriv.evaluate(x);
+                    if (dfx == 0 || !std::isfinite(dfx)) break;
+                    double xNew = x - evaluate(x) / dfx;
+                    if (std::abs(xNew - x) < tolerance) {
+                        found[g] = xNew;
+                        break;
+                    }
+                    x = xNew;
+                }
+            }
+        }, threads);
+        
+        found.erase(std::remove_if(found.begin(), found.end(), [](double r) { return std::isnan(r); }), found.end());
+        return uniqueRoots(found, tolerance);
+    }
+    
+    // Усі корені на [a, b]: паралельне табулювання на сітці, пошук змін знаку, уточнення кожного відрізка
+    std::vector<double> findAllRoots(double a, double b, int samples = 1000, double tolerance = 1e-12,
+                                     unsigned threads = 0) const {
+        if (samples < 2) throw std::invalid_argument("At least two samples are required");
+        if (b < a) std::swap(a, b);
+        
+        double step = (b - a) / (samples - 1);
+        std::vector<double> grid(samples);
+        for (int i = 0; i < samples; ++i) grid[i] = a + i * step;
+        grid[samples - 1] = b;
+        std::vector<double> values = evaluateBatch(grid, threads);
+        
+        std::vector<std::pair<int, int>> brackets;
+        std::vector<double> roots;
+        for (int i = 0; i < samples; ++i) {
+            if (values[i] == 0) {
+                roots.push_back(grid[i]);
+            } else if (i + 1 < samples && values[i + 1] != 0 && (values[i] < 0) != (values[i + 1] < 0)) {
+                brackets.push_back({i, i + 1});
+            }
+        }
+        
+        auto deriv = derivative();
+        std::vector<double> refined(brackets.size(), std::nan(""));
+        parallelForRange(0, brackets.size(), [&](size_t from, size_t to, unsigned) {
+            for (size_t k = from; k < to; ++k) {
+                int lo = brackets[k].first, hi = brackets[k].second;
+                try {
+                    refined[k] = bracketedNewton(*deriv.expression, grid[lo], values[lo],
+                                                 grid[hi], values[hi], tolerance, 200);
+                } catch (const std::runtime_error&) {
+                }
+            }
+        }, threads);
+        
+        for (double r : refined) {
+            if (!std::isnan(r)) roots.push_back(r);
+        }
+        return uniqueRoots(roots, 10 * tolerance);
+    }
+    
+    std::vector<double> evaluateBatch(const std::vector<double>& points, unsigned threads = 0) const {
+        std::vector<double> result(points.size());
+        parallelForRange(0, points.size(), [&](size_t from, size_t to, unsigned) {
+            for (size_t i = from; i < to; ++i) {
+                result[i] = expression->evaluate(points[i]);
+            }
+        }, threads);
+        return result;
+    }
+    
     std::vector<std::pair<double, double>> tabulate(double start, double end, int points) const {
         std::vector<std::pair<double, double>> result;
         double step = (end - start) / (points - 1);
@@ -129,16 +259,102 @@ public:
         out << expression->toString() << "\n";
     }
     
-    void exportTabulatedData(const std::string& filename, double start, double end, int points) const {
-        std::ofstream out(filename);
-        if (!out) throw std::runtime_error("Cannot open file for writing");
+    void exportTabulatedData(const std::string& filename, double start, double end, int points,
+                             ExportFormat format = ExportFormat::TSV) const {
+        BufferedWriter writer(filename, format == ExportFormat::Binary);
+        char delimiter = (format == ExportFormat::CSV) ? ',' : '\t';
+        if (format != ExportFormat::Binary) {
+            writer.write(std::string("x") + delimiter + name + "(x)\n");
+        }
+        
+        // Значення рахуються блоками, таблиця цілком у пам'яті не тримається
+        const int chunkSize = 65536;
+        double step = (end - start) / (points - 1);
+        std::vector<double> values(std::min(chunkSize, std::max(points, 0)));
+        
+        for (int offset = 0; offset < points; offset += chunkSize) {
+            int len = std::min(chunkSize, points - offset);
+            for (int i = 0; i < len; ++i) {
+                values[i] = evaluate(start + (offset + i) * step);
+            }
+            
+            if (format == ExportFormat::Binary) {
+                writer.writeBinaryDoubles(values.data(), len);
+                continue;
+            }
+            for (int i = 0; i < len; ++i) {
+                writer.writeDouble(start + (offset + i) * step);
+                writer.writeChar(delimiter);
+                writer.writeDouble(values[i]);
+                writer.writeChar('\n');
+            }
+        }
+    }
+};
+
+// Будує спрощені похідні один раз і далі рахує коефіцієнти Тейлора в довільній кількості точок
+class TaylorExpander {
+private:
+    std::vector<std::shared_ptr<MathExpression>> derivatives;
+    std::vector<double> inverseFactorials;
+    
+public:
+    TaylorExpander(const MathFunction& func, int terms) {
+        if (terms < 0) throw std::invalid_argument("Number of terms must be non-negative");
+        
+        derivatives.reserve(terms);
+        inverseFactorials.reserve(terms);
+        double factorial = 1.0;
         
-        auto data = tabulate(start, end, points);
-        out << "x\t" << name << "(x)\n";
-        for (const auto& point : data) {
-            out << point.first << "\t" << point.second << "\n";
+        for (int i = 0; i < terms; ++i) {
+            if (i > 0) factorial *= i;
+            inverseFactorials.push_back(1.0 / factorial);
+            
+            if (i == 0) {
+                derivatives.push_back(func.getExpression()->simplify());
+            } else {
+                derivatives.push_back(derivatives.back()->derivative()->simplify());
+            }
+        }
+    }
+    
+    int getTerms() const {
+        return static_cast<int>(derivatives.size());
+    }
+    
+    std::shared_ptr<MathExpression> getDerivative(int order) const {
+        return derivatives.at(order);
+    }
+    
+    void coefficients(double point, double* out) const {
+        for (size_t i = 0; i < derivatives.size(); ++i) {
+            out[i] = derivatives[i]->evaluate(point) * inverseFactorials[i];
         }
     }
+    
+    std::vector<double> coefficients(double point) const {
+        std::vector<double> result(derivatives.size());
+        coefficients(point, result.data());
+        return result;
+    }
+    
+    // Результат у форматі рядків: коефіцієнти для points[p] займають [p * getTerms(), (p + 1) * getTerms())
+    std::vector<double> coefficientsBatch(const std::vector<double>& points, unsigned threads = 0) const {
+        size_t terms = derivatives.size();
+        std::vector<double> result(points.size() * terms);
+        
+        parallelForRange(0, points.size(), [&](size_t from, size_t to, unsigned) {
+            for (size_t p = from; p < to; ++p) {
+                coefficients(points[p], result.data() + p * terms);
+            }
+        }, threads);
+        
+        return result;
+    }
 };
 
+inline std::vector<double> MathFunction::taylorSeries(double point, int terms) const {
+    return TaylorExpander(*this, terms).coefficients(point);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,371 @@
+#ifndef MATRIXREORDERING_H
+#define MATRIXREORDERING_H
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "SparseMatrix.h"
+
+// Перенумерація рядків і стовпців квадратної матриці для локальності доступу до x у SpMV.
+// Перестановка permutation задає нову нумерацію: новий номер i відповідає старому permutation[i].
+// Обидва алгоритми працюють із графом симетричного шаблону A + A^T.
+
+// Граф суміжності у форматі CSR: сусіди вершини v - neighbours[offsets[v]..offsets[v + 1])
+struct AdjacencyGraph {
+    std::vector<size_t> offsets;
+    std::vector<size_t> neighbours;
+    
+    size_t vertexCount() const { return offsets.size() - 1; }
+    size_t degree(size_t v) const { return offsets[v + 1] - offsets[v]; }
+};
+
+// Шаблон A + A^T без діагоналі; два проходи forEachStored замість списку пар
+template<typename T>
+AdjacencyGraph symmetricPattern(const SparseMatrix<T>& matrix) {
+    if (matrix.getRows() != matrix.getCols()) {
+        throw std::invalid_argument("Reordering requires a square matrix");
+    }
+    
+    size_t n = matrix.getRows();
+    AdjacencyGraph graph;
+    graph.offsets.assign(n + 1, 0);
+    matrix.forEachStored([&graph](size_t row, size_t col, const T&) {
+        if (row == col) return;
+        ++graph.offsets[row + 1];
+        ++graph.offsets[col + 1];
+    });
+    for (size_t v = 0; v < n; ++v) graph.offsets[v + 1] += graph.offsets[v];
+    
+    graph.neighbours.resize(graph.offsets[n]);
+    std::vector<size_t> next(graph.offsets.begin(), graph.offsets.end() - 1);
+    matrix.forEachStored([&graph, &next](size_t row, size_t col, const T&) {
+        if (row == col) return;
+        graph.neighbours[next[row]++] = col;
+        graph.neighbours[next[col]++] = row;
+    });
+    
+    // Симетричні елементи дають дублікати - кожен список сортується й ущільнюється
+    size_t write = 0;
+    for (size_t v = 0; v < n; ++v) {
+        auto first = graph.neighbours.begin() + graph.offsets[v];
+        auto last = graph.neighbours.begin() + graph.offsets[v + 1];
+        std::sort(first, last);
+        auto end = std::unique(first, last);
+        graph.offsets[v] = write;
+        write = std::move(first, end, graph.neighbours.begin() + write) - graph.neighbours.begin();
+    }
+    graph.offsets[n] = write;
+    graph.neighbours.resize(write);
+    graph.neighbours.shrink_to_fit();
+    return graph;
+}
+
+// Стан обходів: region[v] - номер підграфа, якому належить вершина (DONE - вже впорядкована),
+// seen[v] == epoch - вершину відвідано поточним обходом
+struct ReorderingState {
+    static constexpr size_t DONE = std::numeric_limits<size_t>::max();
+    
+    std::vector<size_t> region;
+    std::vector<size_t> seen;
+    size_t epoch = 0;
+    
+    explicit ReorderingState(size_t n) : region(n, 0), seen(n, 0) {}
+};
+
+// Обхід у ширину від start у межах region[v] == id; вершини дописуються в order рівень за рівнем.
+// byDegree - сусіди кожної вершини додаються в порядку зростання степеня (Катхілл-Макі).
+// Повертає кількість рівнів, lastLevel - позиція першої вершини останнього рівня в order.
+inline size_t levelTraversal(const AdjacencyGraph& graph, size_t start, size_t id, ReorderingState& state,
+                             std::vector<size_t>& order, bool byDegree, size_t& lastLevel) {
+    size_t epoch = ++state.epoch;
+    size_t levelStart = order.size();
+    order.push_back(start);
+    state.seen[start] = epoch;
+    
+    size_t levels = 0;
+    while (levelStart < order.size()) {
+        size_t levelEnd = order.size();
+        lastLevel = levelStart;
+        ++levels;
+        for (size_t k = levelStart; k < levelEnd; ++k) {
+            size_t v = order[k];
+            size_t added = order.size();
+            for (size_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+                size_t u = graph.neighbours[e];
+                if (state.region[u] == id && state.seen[u] != epoch) {
+                    state.seen[u] = epoch;
+                    order.push_back(u);
+                }
+            }
+            if (byDegree) {
+                std::sort(order.begin() + added, order.end(), [&graph](size_t a, size_t b) {
+                    return graph.degree(a) < graph.degree(b) || (graph.degree(a) == graph.degree(b) && a < b);
+                });
+            }
+        }
+        levelStart = levelEnd;
+    }
+    return levels;
+}
+
+// Псевдопериферійна вершина (Джордж-Лю): перехід до вершини найменшого степеня на останньому
+// рівні, доки глибина структури рівнів зростає. bestOrder - обхід у ширину від знайденої вершини
+inline size_t peripheralVertex(const AdjacencyGraph& graph, size_t start, size_t id, ReorderingState& state,
+                               std::vector<size_t>& bestOrder, std::vector<size_t>& trial) {
+    auto farthest = [&](size_t from, std::vector<size_t>& order, size_t& depth) {
+        order.clear();
+        size_t lastLevel = 0;
+        depth = levelTraversal(graph, from, id, state, order, false, lastLevel);
+        size_t best = order[lastLevel];
+        for (size_t k = lastLevel + 1; k < order.size(); ++k) {
+            if (graph.degree(order[k]) < graph.degree(best)) best = order[k];
+        }
+        return best;
+    };
+    
+    size_t depth = 0;
+    size_t best = start;
+    size_t candidate = farthest(best, bestOrder, depth);
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        size_t candidateDepth = 0;
+        size_t next = farthest(candidate, trial, candidateDepth);
+        if (candidateDepth <= depth) break;
+        best = candidate;
+        depth = candidateDepth;
+        candidate = next;
+        bestOrder.swap(trial);
+    }
+    return best;
+}
+
+// Упорядковує всі вершини підграфа id (усі компоненти зв'язності) обходом у ширину від
+// псевдопериферійних вершин і позначає їх як DONE. Пошук периферійної вершини кожної компоненти
+// починається з першої ще не впорядкованої вершини vertices
+inline std::vector<size_t> orderRegion(const AdjacencyGraph& graph, const std::vector<size_t>& vertices, size_t id,
+                                       ReorderingState& state, bool byDegree) {
+    std::vector<size_t> order;
+    std::vector<size_t> bestOrder;
+    std::vector<size_t> trial;
+    order.reserve(vertices.size());
+    
+    for (size_t v : vertices) {
+        if (state.region[v] != id) continue;
+        size_t root = peripheralVertex(graph, v, id, state, bestOrder, trial);
+        size_t componentStart = order.size();
+        if (byDegree) {
+            size_t lastLevel = 0;
+            levelTraversal(graph, root, id, state, order, true, lastLevel);
+        } else {
+            order.insert(order.end(), bestOrder.begin(), bestOrder.end());
+        }
+        for (size_t k = componentStart; k < order.size(); ++k) state.region[order[k]] = ReorderingState::DONE;
+    }
+    return order;
+}
+
+// Зворотний алгоритм Катхілла-Макі: мінімізує ширину стрічки, ненульові елементи
+// зосереджуються біля діагоналі
+template<typename T>
+std::vector<size_t> reverseCuthillMcKee(const SparseMatrix<T>& matrix) {
+    AdjacencyGraph graph = symmetricPattern(matrix);
+    size_t n = graph.vertexCount();
+    ReorderingState state(n);
+    
+    // Компоненти починаються з вершини найменшого степеня
+    std::vector<size_t> vertices(n);
+    for (size_t v = 0; v < n; ++v) vertices[v] = v;
+    std::stable_sort(vertices.begin(), vertices.end(),
+                     [&graph](size_t a, size_t b) { return graph.degree(a) < graph.degree(b); });
+    std::vector<size_t> order = orderRegion(graph, vertices, 0, state, true);
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Граф у новій нумерації: вершина k - стара order[k]
+inline AdjacencyGraph relabel(const AdjacencyGraph& graph, const std::vector<size_t>& order) {
+    size_t n = graph.vertexCount();
+    std::vector<size_t> inverse(n);
+    for (size_t k = 0; k < n; ++k) inverse[order[k]] = k;
+    
+    AdjacencyGraph result;
+    result.offsets.assign(n + 1, 0);
+    result.neighbours.reserve(graph.neighbours.size());
+    for (size_t k = 0; k < n; ++k) {
+        size_t v = order[k];
+        for (size_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            result.neighbours.push_back(inverse[graph.neighbours[e]]);
+        }
+        result.offsets[k + 1] = result.neighbours.size();
+    }
+    return result;
+}
+
+// Рекурсивна бісекція: підграф ділиться навпіл за порядком обходу в ширину від псевдопериферійної
+// вершини (половини - суцільні "шари" графа), і кожна половина нумерується окремо. Вершини, зв'язані
+// між собою, отримують близькі номери на всіх рівнях - блоки x до leafSize елементів залишаються в кеші.
+// На відміну від вкладеного розсічення, роздільник не виноситься в кінець: мета - локальність SpMV,
+// а не зменшення заповнення при розкладі.
+template<typename T>
+std::vector<size_t> recursiveBisection(const SparseMatrix<T>& matrix, size_t leafSize = 256) {
+    if (leafSize == 0) {
+        throw std::invalid_argument("Leaf size must be positive");
+    }
+    
+    AdjacencyGraph original = symmetricPattern(matrix);
+    size_t n = original.vertexCount();
+    std::vector<size_t> all(n);
+    for (size_t v = 0; v < n; ++v) all[v] = v;
+    
+    // Перший обхід у ширину одразу стає нумерацією графа: подальші обходи читають сусідні
+    // в пам'яті вершини замість випадкових, а обхід усього графа в новій нумерації - це 0..n-1
+    std::vector<size_t> initial;
+    {
+        ReorderingState first(n);
+        initial = orderRegion(original, all, 0, first, false);
+    }
+    AdjacencyGraph graph = relabel(original, initial);
+    original = AdjacencyGraph();
+    
+    ReorderingState state(n);
+    std::vector<size_t> result;
+    result.reserve(n);
+    
+    // Явний стек замість рекурсії: (вершини підграфа, його id); праву половину кладемо першою,
+    // щоб ліву обробити раніше
+    std::vector<std::pair<std::vector<size_t>, size_t>> pending;
+    size_t nextId = 0;
+    auto split = [&](const std::vector<size_t>& order) {
+        if (order.size() <= leafSize) {
+            result.insert(result.end(), order.begin(), order.end());
+            return;
+        }
+        size_t half = order.size() / 2;
+        size_t leftId = ++nextId;
+        size_t rightId = ++nextId;
+        for (size_t k = 0; k < order.size(); ++k) state.region[order[k]] = (k < half) ? leftId : rightId;
+        pending.push_back({std::vector<size_t>(order.begin() + half, order.end()), rightId});
+        pending.push_back({std::vector<size_t>(order.begin(), order.begin() + half), leftId});
+    };
+    
+    split(all);
+    while (!pending.empty()) {
+        std::vector<size_t> vertices = std::move(pending.back().first);
+        size_t id = pending.back().second;
+        pending.pop_back();
+        split(orderRegion(graph, vertices, id, state, false));
+    }
+    
+    for (size_t& v : result) v = initial[v];
+    return result;
+}
+
+// Обернена перестановка з перевіркою, що permutation - перестановка чисел 0..n-1
+inline std::vector<size_t> invertPermutation(const std::vector<size_t>& permutation, size_t n) {
+    if (permutation.size() != n) {
+        throw std::invalid_argument("Permutation size must match matrix size");
+    }
+    
+    std::vector<size_t> inverse(n, ReorderingState::DONE);
+    for (size_t i = 0; i < n; ++i) {
+        size_t old = permutation[i];
+        if (old >= n || inverse[old] != ReorderingState::DONE) {
+            throw std::invalid_argument("Invalid permutation");
+        }
+        inverse[old] = i;
+    }
+    return inverse;
+}
+
+// P * A * P^T у форматі CSR: елемент (r, c) переходить у (inverse[r], inverse[c]).
+// Index = uint32_t вдвічі зменшує обсяг індексів, але для завеликої матриці кидає length_error
+template<typename Index = size_t, typename T>
+CSRSparseMatrix<T, Index> permuteSymmetric(const SparseMatrix<T>& matrix, const std::vector<size_t>& permutation) {
+    if (matrix.getRows() != matrix.getCols()) {
+        throw std::invalid_argument("Reordering requires a square matrix");
+    }
+    
+    size_t n = matrix.getRows();
+    std::vector<size_t> inverse = invertPermutation(permutation, n);
+    
+    std::vector<size_t> counts(n + 1, 0);
+    matrix.forEachStored([&counts, &inverse](size_t row, size_t, const T&) { ++counts[inverse[row] + 1]; });
+    for (size_t i = 0; i < n; ++i) counts[i + 1] += counts[i];
+    size_t nnz = counts[n];
+    if (!CSRSparseMatrix<T, Index>::indexFits(n, nnz)) {
+        throw std::length_error("Matrix is too large for the CSR index type");
+    }
+    
+    std::vector<std::pair<Index, T>> entries(nnz);
+    std::vector<size_t> next(counts.begin(), counts.end() - 1);
+    matrix.forEachStored([&entries, &next, &inverse](size_t row, size_t col, const T& value) {
+        entries[next[inverse[row]]++] = {static_cast<Index>(inverse[col]), value};
+    });
+    
+    std::vector<T> values(nnz);
+    std::vector<Index> colIndices(nnz);
+    std::vector<Index> rowPointers(n + 1);
+    for (size_t i = 0; i < n; ++i) {
+        std::sort(entries.begin() + counts[i], entries.begin() + counts[i + 1],
+                  [](const std::pair<Index, T>& a, const std::pair<Index, T>& b) { return a.first < b.first; });
+        rowPointers[i] = static_cast<Index>(counts[i]);
+    }
+    rowPointers[n] = static_cast<Index>(nnz);
+    for (size_t k = 0; k < nnz; ++k) {
+        colIndices[k] = entries[k].first;
+        values[k] = entries[k].second;
+    }
+    return CSRSparseMatrix<T, Index>(n, n, std::move(values), std::move(colIndices), std::move(rowPointers),
+                                     matrix.getDefaultValue());
+}
+
+// Вектор у новій нумерації: result[i] = x[permutation[i]]
+template<typename T>
+std::vector<T> permuteVector(const std::vector<T>& x, const std::vector<size_t>& permutation) {
+    invertPermutation(permutation, x.size());
+    std::vector<T> result(x.size());
+    for (size_t i = 0; i < x.size(); ++i) result[i] = x[permutation[i]];
+    return result;
+}
+
+// Повернення до початкової нумерації: result[permutation[i]] = y[i]
+template<typename T>
+std::vector<T> unpermuteVector(const std::vector<T>& y, const std::vector<size_t>& permutation) {
+    invertPermutation(permutation, y.size());
+    std::vector<T> result(y.size());
+    for (size_t i = 0; i < y.size(); ++i) result[permutation[i]] = y[i];
+    return result;
+}
+
+// Ширина стрічки max|i - j| і профіль sum(i - f_i), де f_i - перший стовпець рядка i
+// симетричного шаблону (f_i <= i)
+struct BandwidthProfile {
+    size_t bandwidth = 0;
+    size_t profile = 0;
+};
+
+template<typename T>
+BandwidthProfile bandwidthProfile(const SparseMatrix<T>& matrix) {
+    if (matrix.getRows() != matrix.getCols()) {
+        throw std::invalid_argument("Bandwidth requires a square matrix");
+    }
+    
+    size_t n = matrix.getRows();
+    std::vector<size_t> firstColumn(n);
+    for (size_t i = 0; i < n; ++i) firstColumn[i] = i;
+    
+    BandwidthProfile result;
+    matrix.forEachStored([&result, &firstColumn](size_t row, size_t col, const T&) {
+        size_t low = std::min(row, col);
+        size_t high = std::max(row, col);
+        result.bandwidth = std::max(result.bandwidth, high - low);
+        firstColumn[high] = std::min(firstColumn[high], low);
+    });
+    for (size_t i = 0; i < n; ++i) result.profile += i - firstColumn[i];
+    return result;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef PARALLELUTILS_H
+#define PARALLELUTILS_H
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <exception>
+#include <cstddef>
+
+inline unsigned resolveThreadCount(unsigned requested) {
+    if (requested > 0) return requested;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+// Ділить [begin, end) на суцільні блоки, по одному на потік: body(from, to, threadIndex)
+template<typename Func>
+void parallelForRange(size_t begin, size_t end, Func body, unsigned threads = 0) {
+    if (end <= begin) return;
+
+    size_t total = end - begin;
+    size_t workers = std::min<size_t>(resolveThreadCount(threads), total);
+    if (workers <= 1) {
+        body(begin, end, 0u);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    std::vector<std::exception_ptr> errors(workers);
+    size_t chunk = total / workers;
+    size_t extra = total % workers;
+    size_t from = begin;
+
+    for (size_t t = 0; t < workers; ++t) {
+        size_t to = from + chunk + (t < extra ? 1 : 0);
+        pool.emplace_back([&body, &errors, from, to, t]() {
+            try {
+                body(from, to, static_cast<unsigned>(t));
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+        from = to;
+    }
+
+    for (auto& th : pool) th.join();
+    for (const auto& err : errors) {
+        if (err) std::rethrow_exception(err);
+    }
+}
+
+// Попарне (деревоподібне) додавання у фіксованому порядку - результат не залежить від кількості потоків
+inline double pairwiseSum(const double* data, size_t count) {
+    if (count == 0) return 0.0;
+    if (count <= 8) {
+        double sum = 0.0;
+        for (size_t i = 0; i < count; ++i) sum += data[i];
+        return sum;
+    }
+    size_t half = count / 2;
+    return pairwiseSum(data, half) + pairwiseSum(data + half, count - half);
+}
+
+#endif
\ No newline at end of file
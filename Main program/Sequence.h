@@ -7,6 +7,8 @@
 #include <sstream>
 #include <cmath>
 #include <fstream>
+#include "ParallelUtils.h"
+#include "BufferedWriter.h"
 
 class Sequence {
 protected:
@@ -19,6 +21,11 @@ public:
     virtual double getTerm(int n) const = 0;
     virtual std::string toString() const = 0;
     
+    // true, якщо getTerm можна викликати з кількох потоків одночасно (немає спільного змінного стану)
+    virtual bool isParallelSafe() const {
+        return false;
+    }
+    
     std::vector<double> generateTerms(int start, int count) const {
         std::vector<double> terms;
         for (int i = 0; i < count; ++i) {
@@ -35,6 +42,44 @@ public:
         return sum;
     }
     
+    std::vector<double> generateTermsParallel(int start, int count, unsigned threads = 0) const {
+        if (count <= 0) return {};
+        if (!isParallelSafe()) return generateTerms(start, count);
+        
+        std::vector<double> terms(count);
+        parallelForRange(0, static_cast<size_t>(count), [&](size_t from, size_t to, unsigned) {
+            for (size_t i = from; i < to; ++i) {
+                terms[i] = getTerm(start + static_cast<int>(i));
+            }
+        }, threads);
+        return terms;
+    }
+    
+    double partialSumParallel(int start, int end, unsigned threads = 0) const {
+        if (end < start) return 0.0;
+        if (!isParallelSafe()) return partialSum(start, end);
+        
+        // Розбиття на блоки фіксованого розміру, щоб порядок додавання не залежав від threads
+        const size_t blockSize = 4096;
+        size_t count = static_cast<size_t>(end - start) + 1;
+        size_t blocks = (count + blockSize - 1) / blockSize;
+        std::vector<double> blockSums(blocks, 0.0);
+        
+        parallelForRange(0, blocks, [&](size_t from, size_t to, unsigned) {
+            std::vector<double> buffer(blockSize);
+            for (size_t b = from; b < to; ++b) {
+                size_t first = b * blockSize;
+                size_t len = std::min(blockSize, count - first);
+                for (size_t i = 0; i < len; ++i) {
+                    buffer[i] = getTerm(start + static_cast<int>(first + i));
+                }
+                blockSums[b] = pairwiseSum(buffer.data(), len);
+            }
+        }, threads);
+        
+        return pairwiseSum(blockSums.data(), blocks);
+    }
+    
     bool checkConvergence(int testTerms = 1000, double tolerance = 1e-6) const {
         double term = getTerm(testTerms);
         return std::abs(term) < tolerance;
@@ -53,14 +98,42 @@ public:
     }
     
     void saveToFile(const std::string& filename, int start, int count) const {
-        std::ofstream out(filename);
-        if (!out) throw std::runtime_error("Cannot open file");
+        BufferedWriter writer(filename);
+        writer.write("Sequence: " + name + "\n");
+        writeTerms(writer, start, count, ExportFormat::TSV);
+    }
+    
+    // Потоковий експорт: терми генеруються блоками, весь набір у пам'яті не зберігається
+    void exportTerms(const std::string& filename, int start, int count,
+                     ExportFormat format = ExportFormat::CSV, unsigned threads = 0) const {
+        BufferedWriter writer(filename, format == ExportFormat::Binary);
+        writeTerms(writer, start, count, format, threads);
+    }
+    
+private:
+    void writeTerms(BufferedWriter& writer, int start, int count,
+                    ExportFormat format, unsigned threads = 0) const {
+        const int chunkSize = 65536;
+        char delimiter = (format == ExportFormat::CSV) ? ',' : '\t';
         
-        out << "Sequence: " << name << "\n";
-        out << "n\t" << name << "(n)\n";
-        for (int i = 0; i < count; ++i) {
-            int n = start + i;
-            out << n << "\t" << getTerm(n) << "\n";
+        if (format != ExportFormat::Binary) {
+            writer.write(std::string("n") + delimiter + name + "(n)\n");
+        }
+        
+        for (int offset = 0; offset < count; offset += chunkSize) {
+            int len = std::min(chunkSize, count - offset);
+            std::vector<double> chunk = generateTermsParallel(start + offset, len, threads);
+            
+            if (format == ExportFormat::Binary) {
+                writer.writeBinaryDoubles(chunk.data(), chunk.size());
+                continue;
+            }
+            for (int i = 0; i < len; ++i) {
+                writer.writeInteger(start + offset + i);
+                writer.writeChar(delimiter);
+                writer.writeDouble(chunk[i]);
+                writer.writeChar('\n');
+            }
         }
     }
 };
@@ -78,6 +151,10 @@ public:
         return firstTerm + (n - 1) * difference;
     }
     
+    bool isParallelSafe() const override {
+        return true;
+    }
+    
     std::string toString() const override {
         std::ostringstream oss;
         oss << name << "(n) = " << firstTerm << " + " << difference << "*(n-1)";
@@ -98,6 +175,10 @@ public:
         return firstTerm * std::pow(ratio, n - 1);
     }
     
+    bool isParallelSafe() const override {
+        return true;
+    }
+    
     std::string toString() const override {
         std::ostringstream oss;
         oss << name << "(n) = " << firstTerm << " * " << ratio << "^(n-1)";
@@ -132,6 +213,11 @@ public:
         return cache[n - 1];
     }
     
+    // Кеш термів змінюється в getTerm, тому паралельний доступ небезпечний
+    bool isParallelSafe() const override {
+        return false;
+    }
+    
     std::string toString() const override {
         return name + "(n) = recurrence relation";
     }
@@ -150,6 +236,10 @@ public:
         return termFunction(n);
     }
     
+    bool isParallelSafe() const override {
+        return true;
+    }
+    
     std::string toString() const override {
         return name + "(n) = " + formula;
     }
@@ -0,0 +1,188 @@
+#ifndef SPARSEKERNELS_H
+#define SPARSEKERNELS_H
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+// Ядра над упакованими розрідженими векторами: відсортований масив індексів + масив значень.
+// Цикли по щільних масивах мають чотири незалежні акумулятори, щоб компілятор міг
+// векторизувати їх без -ffast-math і без прив'язки до конкретного набору інструкцій.
+
+// sum(values[k] * dense[indices[k]])
+template<typename Index, typename T>
+T sparseDenseDot(const Index* indices, const T* values, size_t count, const T* dense) {
+    T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        s0 += values[k] * dense[indices[k]];
+        s1 += values[k + 1] * dense[indices[k + 1]];
+        s2 += values[k + 2] * dense[indices[k + 2]];
+        s3 += values[k + 3] * dense[indices[k + 3]];
+    }
+    for (; k < count; ++k) s0 += values[k] * dense[indices[k]];
+    return (s0 + s1) + (s2 + s3);
+}
+
+// dense[indices[k]] += alpha * values[k]
+template<typename Index, typename T>
+void sparseAxpy(const T& alpha, const Index* indices, const T* values, size_t count, T* dense) {
+    for (size_t k = 0; k < count; ++k) {
+        dense[indices[k]] += alpha * values[k];
+    }
+}
+
+template<typename T>
+double sumAbs(const T* values, size_t count) {
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        s0 += std::abs(static_cast<double>(values[k]));
+        s1 += std::abs(static_cast<double>(values[k + 1]));
+        s2 += std::abs(static_cast<double>(values[k + 2]));
+        s3 += std::abs(static_cast<double>(values[k + 3]));
+    }
+    for (; k < count; ++k) s0 += std::abs(static_cast<double>(values[k]));
+    return (s0 + s1) + (s2 + s3);
+}
+
+template<typename T>
+double sumSquares(const T* values, size_t count) {
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        double v0 = static_cast<double>(values[k]), v1 = static_cast<double>(values[k + 1]);
+        double v2 = static_cast<double>(values[k + 2]), v3 = static_cast<double>(values[k + 3]);
+        s0 += v0 * v0;
+        s1 += v1 * v1;
+        s2 += v2 * v2;
+        s3 += v3 * v3;
+    }
+    for (; k < count; ++k) {
+        double v = static_cast<double>(values[k]);
+        s0 += v * v;
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+template<typename T>
+double maxAbs(const T* values, size_t count) {
+    double m0 = 0, m1 = 0, m2 = 0, m3 = 0;
+    size_t k = 0;
+    for (; k + 4 <= count; k += 4) {
+        m0 = std::max(m0, std::abs(static_cast<double>(values[k])));
+        m1 = std::max(m1, std::abs(static_cast<double>(values[k + 1])));
+        m2 = std::max(m2, std::abs(static_cast<double>(values[k + 2])));
+        m3 = std::max(m3, std::abs(static_cast<double>(values[k + 3])));
+    }
+    for (; k < count; ++k) m0 = std::max(m0, std::abs(static_cast<double>(values[k])));
+    return std::max(std::max(m0, m1), std::max(m2, m3));
+}
+
+// Перетин відсортованих масивів індексів. Для кожного спільного індексу викликається onMatch(i, j),
+// де i, j - позиції в a і b. Типи індексів масивів можуть різнитися (size_t, uint32_t тощо).
+
+// Лінійне злиття: O(na + nb), просування без розгалужень
+template<typename IndexA, typename IndexB, typename Func>
+void mergeIntersect(const IndexA* a, size_t na, const IndexB* b, size_t nb, Func onMatch) {
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        IndexA x = a[i];
+        IndexB y = b[j];
+        if (x == y) onMatch(i, j);
+        i += (x <= y);
+        j += (y <= x);
+    }
+}
+
+// Галопуючий перетин: кожен індекс короткого масиву a шукається в довгому b експоненційним
+// кроком від попередньої позиції, O(na * log(nb / na))
+template<typename IndexA, typename IndexB, typename Func>
+void gallopingIntersect(const IndexA* a, size_t na, const IndexB* b, size_t nb, Func onMatch) {
+    size_t j = 0;
+    for (size_t i = 0; i < na && j < nb; ++i) {
+        IndexA target = a[i];
+        size_t step = 1;
+        size_t hi = j;
+        while (hi < nb && b[hi] < target) {
+            j = hi + 1;
+            hi += step;
+            step <<= 1;
+        }
+        j = std::lower_bound(b + j, b + std::min(hi + 1, nb), target) - b;
+        if (j < nb && b[j] == target) onMatch(i, j);
+    }
+}
+
+// Блочне порівняння: блоки по 4 індекси порівнюються "всі з усіма" (16 незалежних порівнянь,
+// які компілятор зводить до векторних), далі зсувається блок з меншим максимумом.
+// Хвіст дообробляється злиттям.
+template<typename IndexA, typename IndexB, typename Func>
+void blockIntersect(const IndexA* a, size_t na, const IndexB* b, size_t nb, Func onMatch) {
+    size_t i = 0, j = 0;
+    while (i + 4 <= na && j + 4 <= nb) {
+        unsigned mask = 0;
+        for (unsigned p = 0; p < 4; ++p) {
+            for (unsigned q = 0; q < 4; ++q) {
+                mask |= unsigned(a[i + p] == b[j + q]) << (p * 4 + q);
+            }
+        }
+        while (mask) {
+            unsigned bit = 0;
+            while (!(mask & (1u << bit))) ++bit;
+            onMatch(i + bit / 4, j + bit % 4);
+            mask &= mask - 1;
+        }
+        
+        IndexA maxA = a[i + 3];
+        IndexB maxB = b[j + 3];
+        i += (maxA <= maxB) ? 4 : 0;
+        j += (maxB <= maxA) ? 4 : 0;
+    }
+    
+    size_t restA = na - i, restB = nb - j;
+    mergeIntersect(a + i, restA, b + j, restB, [&onMatch, i, j](size_t x, size_t y) { onMatch(i + x, j + y); });
+}
+
+// Вибір алгоритму (підібрано бенчмарком з меню 7): блочне порівняння виграє в злиття лише
+// з 256-бітними векторами; без них злиття швидше, а галопування окупається раніше
+#if defined(__AVX2__) || defined(__ARM_NEON)
+constexpr bool PREFER_BLOCK_INTERSECT = true;
+constexpr size_t GALLOP_RATIO = 16;
+#else
+constexpr bool PREFER_BLOCK_INTERSECT = false;
+constexpr size_t GALLOP_RATIO = 8;
+#endif
+
+// Адаптивний перетин: галопування, коли довший масив у GALLOP_RATIO і більше разів довший,
+// інакше блочне порівняння або злиття
+template<typename IndexA, typename IndexB, typename Func>
+void intersectShorterFirst(const IndexA* a, size_t na, const IndexB* b, size_t nb, Func onMatch) {
+    if (nb / na >= GALLOP_RATIO) {
+        gallopingIntersect(a, na, b, nb, onMatch);
+    } else if (PREFER_BLOCK_INTERSECT) {
+        blockIntersect(a, na, b, nb, onMatch);
+    } else {
+        mergeIntersect(a, na, b, nb, onMatch);
+    }
+}
+
+template<typename IndexA, typename IndexB, typename Func>
+void intersectSorted(const IndexA* a, size_t na, const IndexB* b, size_t nb, Func onMatch) {
+    if (na == 0 || nb == 0) return;
+    if (na <= nb) {
+        intersectShorterFirst(a, na, b, nb, onMatch);
+    } else {
+        intersectShorterFirst(b, nb, a, na, [&onMatch](size_t j, size_t i) { onMatch(i, j); });
+    }
+}
+
+// Розріджений скалярний добуток через адаптивний перетин
+template<typename IndexA, typename IndexB, typename T>
+T sparseDot(const IndexA* ia, const T* va, size_t na, const IndexB* ib, const T* vb, size_t nb) {
+    T sum = T();
+    intersectSorted(ia, na, ib, nb, [&sum, va, vb](size_t i, size_t j) { sum += va[i] * vb[j]; });
+    return sum;
+}
+
+#endif
\ No newline at end of file
@@ -2,7 +2,13 @@
 #define SPARSELIST_H
 
 #include "ISparseContainer.h"
+#include "SparseKernels.h"
 #include <map>
+#include <iterator>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <fstream>
 #include <stdexcept>
@@ -14,7 +20,111 @@ private:
     size_t listSize;
     T defaultValue;
     
+    // Перший індекс без збереженого значення, або listSize, якщо таких немає
+    size_t firstGap() const {
+        size_t expected = 0;
+        for (const auto& pair : data) {
+            if (pair.first > expected) break;
+            expected = pair.first + 1;
+        }
+        return expected;
+    }
+    
+    // Порядок обходу пакета за зростанням індексу; стабільний, тож серед повторів останній лишається останнім
+    static std::vector<size_t> batchOrder(const std::vector<size_t>& indices) {
+        std::vector<size_t> order(indices.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        if (!std::is_sorted(indices.begin(), indices.end())) {
+            std::stable_sort(order.begin(), order.end(),
+                             [&indices](size_t a, size_t b) { return indices[a] < indices[b]; });
+        }
+        return order;
+    }
+    
+    // Арифметика працює лише зі збереженими елементами, тож вимагає нульового значення за замовчуванням
+    void requireZeroDefault() const {
+        if (!(defaultValue == T())) {
+            throw std::runtime_error("Sparse arithmetic requires a zero default value");
+        }
+    }
+    
+    // Перетин збережених елементів: onMatch(index, valueA, valueB) у порядку зростання індексу.
+    // Для співмірних списків - злиття; якщо один у GALLOP_RATIO разів більший, по ньому робиться
+    // кілька кроків вперед від попередньої позиції, а далі lower_bound - аналог галопування для дерева
+    template<typename Func>
+    static void intersectStored(const std::map<size_t, T>& a, const std::map<size_t, T>& b, Func onMatch) {
+        if (a.empty() || b.empty()) return;
+        bool swapped = a.size() > b.size();
+        const auto& small = swapped ? b : a;
+        const auto& large = swapped ? a : b;
+        auto match = [&onMatch, swapped](size_t index, const T& fromSmall, const T& fromLarge) {
+            if (swapped) {
+                onMatch(index, fromLarge, fromSmall);
+            } else {
+                onMatch(index, fromSmall, fromLarge);
+            }
+        };
+        
+        auto it = large.begin();
+        if (large.size() / small.size() >= GALLOP_RATIO) {
+            for (const auto& pair : small) {
+                for (int step = 0; step < 8 && it != large.end() && it->first < pair.first; ++step) ++it;
+                if (it != large.end() && it->first < pair.first) it = large.lower_bound(pair.first);
+                if (it == large.end()) return;
+                if (it->first == pair.first) match(pair.first, pair.second, it->second);
+            }
+            return;
+        }
+        
+        auto sIt = small.begin();
+        while (sIt != small.end() && it != large.end()) {
+            if (sIt->first < it->first) {
+                ++sIt;
+            } else if (it->first < sIt->first) {
+                ++it;
+            } else {
+                match(sIt->first, sIt->second, it->second);
+                ++sIt;
+                ++it;
+            }
+        }
+    }
+    
 public:
+    // Ітератор по збережених елементах у порядку зростання індексу
+    class const_iterator {
+    private:
+        typename std::map<size_t, T>::const_iterator it;
+    
+    public:
+        // Посилання - тимчасовий SparseEntry, тому категорія input, а для std::ranges - forward
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = SparseEntry<T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = SparseEntry<T>;
+        using pointer = void;
+        
+        const_iterator() = default;
+        explicit const_iterator(typename std::map<size_t, T>::const_iterator position) : it(position) {}
+        
+        reference operator*() const { return {it->first, it->second}; }
+        
+        const_iterator& operator++() {
+            ++it;
+            return *this;
+        }
+        
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++it;
+            return copy;
+        }
+        
+        bool operator==(const const_iterator& other) const { return it == other.it; }
+        bool operator!=(const const_iterator& other) const { return it != other.it; }
+    };
+    
     SparseList(size_t size = 0, const T& defVal = T()) 
         : listSize(size), defaultValue(defVal) {}
     
@@ -38,14 +148,88 @@ public:
         }
     }
     
-    int findByValue(const T& value) const override {
-        if (value == defaultValue) {
-            for (size_t i = 0; i < listSize; ++i) {
-                if (data.find(i) == data.end()) {
-                    return static_cast<int>(i);
+    // Великий пакет зливається з наявними елементами в нову map за один прохід (вузли переносяться без копіювання),
+    // малий вставляється з підказкою позиції без перебудови дерева
+    void setBatch(const std::vector<size_t>& indices, const std::vector<T>& values) override {
+        if (indices.size() != values.size()) {
+            throw std::invalid_argument("Indices and values must have the same length");
+        }
+        if (indices.empty()) return;
+        
+        std::vector<size_t> order = batchOrder(indices);
+        size_t maxIndex = indices[order.back()];
+        if (maxIndex >= listSize) {
+            listSize = maxIndex + 1;
+        }
+        
+        if (order.size() < data.size()) {
+            for (size_t k = 0; k < order.size(); ++k) {
+                size_t idx = indices[order[k]];
+                if (k + 1 < order.size() && indices[order[k + 1]] == idx) continue;
+                const T& value = values[order[k]];
+                
+                auto it = data.lower_bound(idx);
+                bool present = (it != data.end() && it->first == idx);
+                if (value == defaultValue) {
+                    if (present) data.erase(it);
+                } else if (present) {
+                    it->second = value;
+                } else {
+                    data.emplace_hint(it, idx, value);
                 }
             }
-            return -1;
+            return;
+        }
+        
+        std::map<size_t, T> merged;
+        auto existing = data.begin();
+        for (size_t k = 0; k < order.size(); ++k) {
+            size_t idx = indices[order[k]];
+            if (k + 1 < order.size() && indices[order[k + 1]] == idx) continue;
+            
+            while (existing != data.end() && existing->first < idx) {
+                merged.insert(merged.end(), data.extract(existing++));
+            }
+            if (existing != data.end() && existing->first == idx) ++existing;
+            
+            const T& value = values[order[k]];
+            if (!(value == defaultValue)) {
+                merged.emplace_hint(merged.end(), idx, value);
+            }
+        }
+        while (existing != data.end()) {
+            merged.insert(merged.end(), data.extract(existing++));
+        }
+        data.swap(merged);
+    }
+    
+    // Запити обробляються за зростанням індексу: для великого пакета - один прохід по map
+    void gatherBatch(const std::vector<size_t>& indices, std::vector<T>& out) const override {
+        out.resize(indices.size());
+        if (indices.empty()) return;
+        
+        std::vector<size_t> order = batchOrder(indices);
+        if (indices[order.back()] >= listSize) {
+            throw std::out_of_range("Index out of range");
+        }
+        
+        bool walk = indices.size() >= data.size();
+        auto it = data.begin();
+        for (size_t k = 0; k < order.size(); ++k) {
+            size_t idx = indices[order[k]];
+            if (walk) {
+                while (it != data.end() && it->first < idx) ++it;
+            } else {
+                it = data.lower_bound(idx);
+            }
+            out[order[k]] = (it != data.end() && it->first == idx) ? it->second : defaultValue;
+        }
+    }
+    
+    int findByValue(const T& value) const override {
+        if (value == defaultValue) {
+            size_t gap = firstGap();
+            return gap < listSize ? static_cast<int>(gap) : -1;
         }
         
         for (const auto& pair : data) {
@@ -56,20 +240,157 @@ public:
         return -1;
     }
     
+    // Предикат перевіряється на значенні за замовчуванням один раз, далі лише на збережених елементах
     int findFirstBy(std::function<bool(const T&)> predicate) const override {
-        for (size_t i = 0; i < listSize; ++i) {
-            T val = get(i);
-            if (predicate(val)) {
-                return static_cast<int>(i);
-            }
+        if (listSize == 0) return -1;
+        bool defaultMatches = predicate(defaultValue);
+        
+        size_t expected = 0;
+        for (const auto& pair : data) {
+            if (defaultMatches && pair.first > expected) return static_cast<int>(expected);
+            if (predicate(pair.second)) return static_cast<int>(pair.first);
+            expected = pair.first + 1;
         }
-        return -1;
+        return (defaultMatches && expected < listSize) ? static_cast<int>(expected) : -1;
+    }
+    
+    void forEachStored(std::function<void(size_t, const T&)> visitor) const override {
+        for (const auto& pair : data) {
+            visitor(pair.first, pair.second);
+        }
+    }
+    
+    const_iterator begin() const {
+        return const_iterator(data.begin());
+    }
+    
+    const_iterator end() const {
+        return const_iterator(data.end());
     }
     
     size_t size() const override {
         return listSize;
     }
     
+    // Збережені елементи як упаковані масиви для ядер з SparseKernels.h
+    void pack(std::vector<size_t>& indices, std::vector<T>& values) const {
+        indices.clear();
+        values.clear();
+        indices.reserve(data.size());
+        values.reserve(data.size());
+        for (const auto& pair : data) {
+            indices.push_back(pair.first);
+            values.push_back(pair.second);
+        }
+    }
+    
+    T dot(const SparseList<T>& other) const {
+        requireZeroDefault();
+        other.requireZeroDefault();
+        T sum = T();
+        intersectStored(data, other.data, [&sum](size_t, const T& a, const T& b) { sum += a * b; });
+        return sum;
+    }
+    
+    // Поелементний добуток; результат має розмір більшого зі списків
+    SparseList<T> multiplyElementwise(const SparseList<T>& other) const {
+        requireZeroDefault();
+        other.requireZeroDefault();
+        SparseList<T> result(std::max(listSize, other.listSize), T());
+        intersectStored(data, other.data, [&result](size_t index, const T& a, const T& b) {
+            T product = a * b;
+            if (!(product == T())) result.data.emplace_hint(result.data.end(), index, product);
+        });
+        return result;
+    }
+    
+    T dot(const std::vector<T>& dense) const {
+        requireZeroDefault();
+        if (dense.size() != listSize) {
+            throw std::invalid_argument("Vector size must match list size");
+        }
+        T sum = T();
+        for (const auto& pair : data) {
+            sum += pair.second * dense[pair.first];
+        }
+        return sum;
+    }
+    
+    // this = alpha * x + this; нові елементи вставляються з підказкою позиції, нулі видаляються
+    void axpy(const T& alpha, const SparseList<T>& x) {
+        requireZeroDefault();
+        x.requireZeroDefault();
+        if (x.listSize > listSize) listSize = x.listSize;
+        if (alpha == T()) return;
+        
+        auto it = data.begin();
+        for (const auto& pair : x.data) {
+            while (it != data.end() && it->first < pair.first) ++it;
+            if (it != data.end() && it->first == pair.first) {
+                it->second += alpha * pair.second;
+                if (it->second == T()) {
+                    it = data.erase(it);
+                } else {
+                    ++it;
+                }
+            } else {
+                T value = alpha * pair.second;
+                if (!(value == T())) data.emplace_hint(it, pair.first, value);
+            }
+        }
+    }
+    
+    // dense = alpha * this + dense
+    void addScaledTo(const T& alpha, std::vector<T>& dense) const {
+        requireZeroDefault();
+        if (dense.size() != listSize) {
+            throw std::invalid_argument("Vector size must match list size");
+        }
+        for (const auto& pair : data) {
+            dense[pair.first] += alpha * pair.second;
+        }
+    }
+    
+    void scale(const T& alpha) {
+        requireZeroDefault();
+        if (alpha == T()) {
+            data.clear();
+            return;
+        }
+        for (auto it = data.begin(); it != data.end();) {
+            it->second *= alpha;
+            if (it->second == T()) {
+                it = data.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    
+    double norm1() const {
+        requireZeroDefault();
+        double sum = 0.0;
+        for (const auto& pair : data) sum += std::abs(static_cast<double>(pair.second));
+        return sum;
+    }
+    
+    double norm2() const {
+        requireZeroDefault();
+        double sum = 0.0;
+        for (const auto& pair : data) {
+            double v = static_cast<double>(pair.second);
+            sum += v * v;
+        }
+        return std::sqrt(sum);
+    }
+    
+    double normInf() const {
+        requireZeroDefault();
+        double result = 0.0;
+        for (const auto& pair : data) result = std::max(result, std::abs(static_cast<double>(pair.second)));
+        return result;
+    }
+    
     size_t nonZeroCount() const override {
         return data.size();
     }
@@ -7,6 +7,27 @@
 #include <fstream>
 #include <stdexcept>
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include <limits>
+#include <type_traits>
+#include "ISparseContainer.h"
+#include "SparseKernels.h"
+#include "ParallelUtils.h"
+#include "BFloat16.h"
+
+// Збережений елемент матриці, який повертають ітератори; посилання дійсне, доки матриця не змінюється
+template<typename T>
+struct MatrixEntry {
+    size_t row;
+    size_t col;
+    const T& value;
+};
 
 template<typename T>
 class SparseMatrix {
@@ -28,26 +49,392 @@ public:
     
     size_t getRows() const { return rows; }
     size_t getCols() const { return cols; }
+    const T& getDefaultValue() const { return defaultValue; }
+    
+    // Обхід лише збережених елементів; порядок залежить від формату зберігання
+    virtual void forEachStored(std::function<void(size_t, size_t, const T&)> visitor) const = 0;
     
     virtual SparseMatrix<T>* add(const SparseMatrix<T>& other) const = 0;
     virtual SparseMatrix<T>* multiply(const SparseMatrix<T>& other) const = 0;
     virtual std::vector<T> multiplyVector(const std::vector<T>& vec) const = 0;
     virtual SparseMatrix<T>* transpose() const = 0;
     
+    // result = A * vec у вже наявний вектор; потрібне ітераційним розв'язувачам, щоб не виділяти
+    // пам'ять на кожній ітерації. Базова реалізація просто копіює multiplyVector
+    virtual void multiplyVectorInto(const std::vector<T>& vec, std::vector<T>& result, unsigned threads = 0) const {
+        (void)threads;
+        result = multiplyVector(vec);
+    }
+    
     virtual void saveToFile(const std::string& filename) const = 0;
     virtual void loadFromFile(const std::string& filename) = 0;
 };
 
+// Політики зберігання для MapSparseMatrix.
+// TreeStorage - std::map з впорядкованим обходом, O(log nnz) на доступ.
+// HashStorage - хеш-таблиця з відкритою адресацією, ключ - упакований 64-бітний (row << 32 | col),
+// O(1) в середньому на доступ, обхід невпорядкований.
 template<typename T>
-class MapSparseMatrix : public SparseMatrix<T> {
+class TreeStorage {
 private:
     std::map<std::pair<size_t, size_t>, T> data;
     
+public:
+    static constexpr bool ordered = true;
+    
+    class const_iterator {
+    private:
+        typename std::map<std::pair<size_t, size_t>, T>::const_iterator it;
+    
+    public:
+        // operator* повертає проксі за значенням, тож за правилами C++17 це input-ітератор;
+        // концептам C++20 (std::ranges) достатньо iterator_concept
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = MatrixEntry<T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = MatrixEntry<T>;
+        using pointer = void;
+        
+        const_iterator() = default;
+        explicit const_iterator(typename std::map<std::pair<size_t, size_t>, T>::const_iterator position)
+            : it(position) {}
+        
+        reference operator*() const { return {it->first.first, it->first.second, it->second}; }
+        
+        const_iterator& operator++() {
+            ++it;
+            return *this;
+        }
+        
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++it;
+            return copy;
+        }
+        
+        bool operator==(const const_iterator& other) const { return it == other.it; }
+        bool operator!=(const const_iterator& other) const { return it != other.it; }
+    };
+    
+    const_iterator begin() const { return const_iterator(data.begin()); }
+    const_iterator end() const { return const_iterator(data.end()); }
+    
+    const T* find(size_t row, size_t col) const {
+        auto it = data.find({row, col});
+        return (it != data.end()) ? &it->second : nullptr;
+    }
+    
+    void insert(size_t row, size_t col, const T& value) {
+        data[{row, col}] = value;
+    }
+    
+    void erase(size_t row, size_t col) {
+        data.erase({row, col});
+    }
+    
+    // Вставка ключів у порядку зростання - з підказкою кінця, амортизовано O(1)
+    void append(size_t row, size_t col, const T& value) {
+        data.emplace_hint(data.end(), std::make_pair(row, col), value);
+    }
+    
+    size_t size() const {
+        return data.size();
+    }
+    
+    void clear() {
+        data.clear();
+    }
+    
+    void reserve(size_t /*count*/) {}
+    
+    template<typename Func>
+    void forEach(Func func) const {
+        for (const auto& entry : data) {
+            func(entry.first.first, entry.first.second, entry.second);
+        }
+    }
+};
+
+template<typename T>
+class HashStorage {
+private:
+    static constexpr uint64_t EMPTY = ~uint64_t(0);
+    static constexpr uint64_t ERASED = ~uint64_t(0) - 1;
+    
+    std::vector<uint64_t> keys;
+    std::vector<T> values;
+    size_t count;
+    size_t used;    // зайняті слоти разом із видаленими
+    
+    static uint64_t pack(size_t row, size_t col) {
+        if (row >= 0xFFFFFFFFu || col >= 0xFFFFFFFFu) {
+            throw std::out_of_range("HashStorage supports indices below 2^32 - 1");
+        }
+        return (static_cast<uint64_t>(row) << 32) | static_cast<uint64_t>(col);
+    }
+    
+    size_t slotOf(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 17) & (keys.size() - 1);
+    }
+    
+    // Слот із ключем або перший вільний/видалений слот для вставки
+    size_t probe(uint64_t key, bool& found) const {
+        size_t mask = keys.size() - 1;
+        size_t pos = slotOf(key);
+        size_t firstErased = keys.size();
+        while (true) {
+            if (keys[pos] == key) {
+                found = true;
+                return pos;
+            }
+            if (keys[pos] == EMPTY) {
+                found = false;
+                return firstErased < keys.size() ? firstErased : pos;
+            }
+            if (keys[pos] == ERASED && firstErased == keys.size()) firstErased = pos;
+            pos = (pos + 1) & mask;
+        }
+    }
+    
+    void rehash(size_t slotCount) {
+        std::vector<uint64_t> oldKeys(slotCount, EMPTY);
+        std::vector<T> oldValues(slotCount);
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+        count = 0;
+        used = 0;
+        for (size_t i = 0; i < oldKeys.size(); ++i) {
+            if (oldKeys[i] != EMPTY && oldKeys[i] != ERASED) {
+                bool found;
+                size_t pos = probe(oldKeys[i], found);
+                keys[pos] = oldKeys[i];
+                values[pos] = std::move(oldValues[i]);
+                ++count;
+                ++used;
+            }
+        }
+    }
+    
+public:
+    static constexpr bool ordered = false;
+    
+    // Пропускає порожні й видалені слоти
+    class const_iterator {
+    private:
+        const uint64_t* key;
+        const uint64_t* keyEnd;
+        const T* value;
+        
+        void skipFree() {
+            while (key != keyEnd && (*key == EMPTY || *key == ERASED)) {
+                ++key;
+                ++value;
+            }
+        }
+    
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = MatrixEntry<T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = MatrixEntry<T>;
+        using pointer = void;
+        
+        const_iterator() : key(nullptr), keyEnd(nullptr), value(nullptr) {}
+        const_iterator(const uint64_t* k, const uint64_t* kEnd, const T* v) : key(k), keyEnd(kEnd), value(v) {
+            skipFree();
+        }
+        
+        reference operator*() const {
+            return {static_cast<size_t>(*key >> 32), static_cast<size_t>(*key & 0xFFFFFFFFu), *value};
+        }
+        
+        const_iterator& operator++() {
+            ++key;
+            ++value;
+            skipFree();
+            return *this;
+        }
+        
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+        
+        bool operator==(const const_iterator& other) const { return key == other.key; }
+        bool operator!=(const const_iterator& other) const { return key != other.key; }
+    };
+    
+    const_iterator begin() const {
+        return const_iterator(keys.data(), keys.data() + keys.size(), values.data());
+    }
+    
+    const_iterator end() const {
+        return const_iterator(keys.data() + keys.size(), keys.data() + keys.size(), values.data() + values.size());
+    }
+    
+    HashStorage() : keys(16, EMPTY), values(16), count(0), used(0) {}
+    
+    const T* find(size_t row, size_t col) const {
+        if (row >= 0xFFFFFFFFu || col >= 0xFFFFFFFFu) return nullptr;
+        bool found;
+        size_t pos = probe(pack(row, col), found);
+        return found ? &values[pos] : nullptr;
+    }
+    
+    void insert(size_t row, size_t col, const T& value) {
+        if ((used + 1) * 2 > keys.size()) {
+            rehash(count * 4 > keys.size() ? keys.size() * 2 : keys.size());
+        }
+        uint64_t key = pack(row, col);
+        bool found;
+        size_t pos = probe(key, found);
+        if (!found) {
+            if (keys[pos] == EMPTY) ++used;
+            keys[pos] = key;
+            ++count;
+        }
+        values[pos] = value;
+    }
+    
+    void append(size_t row, size_t col, const T& value) {
+        insert(row, col, value);
+    }
+    
+    void erase(size_t row, size_t col) {
+        if (row >= 0xFFFFFFFFu || col >= 0xFFFFFFFFu) return;
+        bool found;
+        size_t pos = probe(pack(row, col), found);
+        if (found) {
+            keys[pos] = ERASED;
+            values[pos] = T();
+            --count;
+        }
+    }
+    
+    size_t size() const {
+        return count;
+    }
+    
+    void clear() {
+        keys.assign(16, EMPTY);
+        values.assign(16, T());
+        count = 0;
+        used = 0;
+    }
+    
+    void reserve(size_t expected) {
+        size_t slots = keys.size();
+        while (slots < expected * 2) slots <<= 1;
+        if (slots > keys.size()) rehash(slots);
+    }
+    
+    template<typename Func>
+    void forEach(Func func) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] != EMPTY && keys[i] != ERASED) {
+                func(static_cast<size_t>(keys[i] >> 32), static_cast<size_t>(keys[i] & 0xFFFFFFFFu), values[i]);
+            }
+        }
+    }
+};
+
+// Index - тип індексів і вказівників на рядки/стовпці. За замовчуванням size_t, тож матриця будь-якого
+// розміру вміщується; uint32_t вдвічі зменшує обсяг індексів, якщо кількість стовпців (рядків для CSC)
+// і збережених елементів вміщується в 32 біти. Його вибирають явно (тоді завелика матриця дає
+// length_error) або автоматично через makeCompactCSR.
+// Value - тип, у якому CSR зберігає значення (float, BFloat16 для T = double); обчислення ведуться в T
+template<typename T, typename Index = size_t, typename Value = T>
+class CSRSparseMatrix;
+
+template<typename T, typename Index = size_t>
+class CSCSparseMatrix;
+
+// Ітератор по одному рядку CSR або стовпцю CSC: index - номер стовпця/рядка всередині зрізу
+template<typename T, typename Index = size_t>
+class CompressedSliceIterator {
+private:
+    const Index* index;
+    const T* value;
+    
+public:
+    using iterator_category = std::input_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+    using value_type = SparseEntry<T>;
+    using difference_type = std::ptrdiff_t;
+    using reference = SparseEntry<T>;
+    using pointer = void;
+    
+    CompressedSliceIterator() : index(nullptr), value(nullptr) {}
+    CompressedSliceIterator(const Index* i, const T* v) : index(i), value(v) {}
+    
+    reference operator*() const { return {static_cast<size_t>(*index), *value}; }
+    
+    CompressedSliceIterator& operator++() {
+        ++index;
+        ++value;
+        return *this;
+    }
+    
+    CompressedSliceIterator operator++(int) {
+        CompressedSliceIterator copy = *this;
+        ++*this;
+        return copy;
+    }
+    
+    bool operator==(const CompressedSliceIterator& other) const { return index == other.index; }
+    bool operator!=(const CompressedSliceIterator& other) const { return index != other.index; }
+};
+
+// y = M * x для стиснутого формату, у якому внесок кожного елемента зовнішнього зрізу o
+// розкидається в y[indices[j]] (A^T * x для CSR, A * x для CSC). Кожен потік розкидає у власний
+// буфер, буфери потім сумуються по діапазонах y - без атомарних операцій і без транспонування.
+// Результат пишеться в result, пам'ять під нього виділяється лише при зміні розміру.
+template<typename T, typename Index, typename Value>
+void compressedScatterMultiply(size_t outerCount, size_t innerCount, const std::vector<Index>& pointers,
+                               const std::vector<Index>& indices, const std::vector<Value>& values,
+                               const std::vector<T>& x, std::vector<T>& result, unsigned threads) {
+    size_t nnz = values.size();
+    size_t workers = resolveThreadCount(threads);
+    workers = std::min(workers, std::max<size_t>(1, nnz / (size_t(1) << 15)));
+    workers = std::min(workers, std::max<size_t>(1, 2 * nnz / std::max<size_t>(innerCount, 1)));
+    workers = std::min(workers, std::max<size_t>(outerCount, 1));
+    
+    result.assign(innerCount, T());
+    std::vector<std::vector<T>> buffers(workers - 1, std::vector<T>(innerCount, T()));
+    parallelForRange(0, outerCount, [&](size_t from, size_t to, unsigned t) {
+        T* out = (t == 0) ? result.data() : buffers[t - 1].data();
+        for (size_t o = from; o < to; ++o) {
+            T xo = x[o];
+            for (size_t j = pointers[o]; j < pointers[o + 1]; ++j) {
+                out[indices[j]] += static_cast<T>(values[j]) * xo;
+            }
+        }
+    }, static_cast<unsigned>(workers));
+    
+    if (!buffers.empty()) {
+        parallelForRange(0, innerCount, [&](size_t from, size_t to, unsigned) {
+            for (const auto& buffer : buffers) {
+                for (size_t i = from; i < to; ++i) result[i] += buffer[i];
+            }
+        }, static_cast<unsigned>(workers));
+    }
+}
+
+template<typename T, typename Storage = TreeStorage<T>>
+class MapSparseMatrix : public SparseMatrix<T> {
+private:
+    Storage data;
+    
     using SparseMatrix<T>::rows;
     using SparseMatrix<T>::cols;
     using SparseMatrix<T>::defaultValue;
     
 public:
+    using const_iterator = typename Storage::const_iterator;
+    
     MapSparseMatrix(size_t r = 0, size_t c = 0, const T& defVal = T())
         : SparseMatrix<T>(r, c, defVal) {}
     
@@ -55,8 +442,8 @@ public:
         if (row >= rows || col >= cols) {
             throw std::out_of_range("Matrix index out of range");
         }
-        auto it = data.find({row, col});
-        return (it != data.end()) ? it->second : defaultValue;
+        const T* value = data.find(row, col);
+        return value ? *value : defaultValue;
     }
     
     void set(size_t row, size_t col, const T& value) override {
@@ -65,9 +452,9 @@ public:
         }
         
         if (value == defaultValue) {
-            data.erase({row, col});
+            data.erase(row, col);
         } else {
-            data[{row, col}] = value;
+            data.insert(row, col, value);
         }
     }
     
@@ -75,6 +462,19 @@ public:
         return data.size();
     }
     
+    // Ітерація по збережених елементах; для HashStorage порядок невизначений
+    const_iterator begin() const {
+        return data.begin();
+    }
+    
+    const_iterator end() const {
+        return data.end();
+    }
+    
+    void forEachStored(std::function<void(size_t, size_t, const T&)> visitor) const override {
+        data.forEach(visitor);
+    }
+    
     std::string toString() const override {
         std::ostringstream oss;
         oss << "MapSparseMatrix[" << rows << "x" << cols << ", stored=" << data.size() << "]:\n";
@@ -105,7 +505,16 @@ public:
             throw std::invalid_argument("Matrix dimensions must match for addition");
         }
         
-        MapSparseMatrix<T>* result = new MapSparseMatrix<T>(rows, cols, defaultValue);
+        MapSparseMatrix<T, Storage>* result = new MapSparseMatrix<T, Storage>(rows, cols, defaultValue);
+        
+        // З нульовими значеннями за замовчуванням досить пройти лише збережені елементи обох матриць
+        if (defaultValue == T() && other.getDefaultValue() == T()) {
+            result->data = data;
+            other.forEachStored([result](size_t row, size_t col, const T& value) {
+                result->set(row, col, result->get(row, col) + value);
+            });
+            return result;
+        }
         
         for (size_t i = 0; i < rows; ++i) {
             for (size_t j = 0; j < cols; ++j) {
@@ -124,7 +533,21 @@ public:
             throw std::invalid_argument("Invalid dimensions for matrix multiplication");
         }
         
-        MapSparseMatrix<T>* result = new MapSparseMatrix<T>(rows, other.getCols(), defaultValue);
+        MapSparseMatrix<T, Storage>* result = new MapSparseMatrix<T, Storage>(rows, other.getCols(), defaultValue);
+        
+        // Розріджений добуток: рядки other групуються один раз, далі кожен a(i,k) множиться лише на рядок k
+        if (defaultValue == T() && other.getDefaultValue() == T()) {
+            std::vector<std::vector<std::pair<size_t, T>>> otherRows(other.getRows());
+            other.forEachStored([&otherRows](size_t row, size_t col, const T& value) {
+                otherRows[row].push_back({col, value});
+            });
+            data.forEach([result, &otherRows](size_t row, size_t k, const T& a) {
+                for (const auto& entry : otherRows[k]) {
+                    result->set(row, entry.first, result->get(row, entry.first) + a * entry.second);
+                }
+            });
+            return result;
+        }
         
         for (size_t i = 0; i < rows; ++i) {
             for (size_t j = 0; j < other.getCols(); ++j) {
@@ -147,6 +570,13 @@ public:
         }
         
         std::vector<T> result(rows, defaultValue);
+        if (defaultValue == T()) {
+            data.forEach([&result, &vec](size_t row, size_t col, const T& value) {
+                result[row] = result[row] + value * vec[col];
+            });
+            return result;
+        }
+        
         for (size_t i = 0; i < rows; ++i) {
             T sum = defaultValue;
             for (size_t j = 0; j < cols; ++j) {
@@ -159,15 +589,61 @@ public:
     }
     
     SparseMatrix<T>* transpose() const override {
-        MapSparseMatrix<T>* result = new MapSparseMatrix<T>(cols, rows, defaultValue);
+        MapSparseMatrix<T, Storage>* result = new MapSparseMatrix<T, Storage>(cols, rows, defaultValue);
         
-        for (const auto& entry : data) {
-            result->set(entry.first.second, entry.first.first, entry.second);
+        // Записи збираються й сортуються один раз, далі вставляються по порядку без пошуку позиції
+        std::vector<std::pair<std::pair<size_t, size_t>, T>> entries;
+        entries.reserve(data.size());
+        data.forEach([&entries](size_t row, size_t col, const T& value) {
+            entries.push_back({{col, row}, value});
+        });
+        if (Storage::ordered) {
+            std::sort(entries.begin(), entries.end(),
+                      [](const auto& a, const auto& b) { return a.first < b.first; });
+        }
+        
+        result->data.reserve(entries.size());
+        for (const auto& entry : entries) {
+            result->data.append(entry.first.first, entry.first.second, entry.second);
         }
         
         return result;
     }
     
+    // Перетворення в CSR: записи збираються один раз і сортуються, лише якщо сховище невпорядковане.
+    // Якщо матриця не вміщується в явно вибраний Index, кидає length_error
+    template<typename Index = size_t>
+    CSRSparseMatrix<T, Index> toCSR() const {
+        if (!CSRSparseMatrix<T, Index>::indexFits(cols, data.size())) {
+            throw std::length_error("Matrix is too large for the CSR index type");
+        }
+        
+        std::vector<std::pair<std::pair<size_t, size_t>, T>> entries;
+        entries.reserve(data.size());
+        data.forEach([&entries](size_t row, size_t col, const T& value) {
+            entries.push_back({{row, col}, value});
+        });
+        if (!Storage::ordered) {
+            std::sort(entries.begin(), entries.end(),
+                      [](const auto& a, const auto& b) { return a.first < b.first; });
+        }
+        
+        std::vector<T> values;
+        std::vector<Index> colIndices;
+        std::vector<Index> rowPointers(rows + 1, 0);
+        values.reserve(entries.size());
+        colIndices.reserve(entries.size());
+        for (const auto& entry : entries) {
+            ++rowPointers[entry.first.first + 1];
+            colIndices.push_back(static_cast<Index>(entry.first.second));
+            values.push_back(entry.second);
+        }
+        for (size_t i = 0; i < rows; ++i) rowPointers[i + 1] += rowPointers[i];
+        
+        return CSRSparseMatrix<T, Index>(rows, cols, std::move(values), std::move(colIndices),
+                                         std::move(rowPointers), defaultValue);
+    }
+    
     void saveToFile(const std::string& filename) const override {
         std::ofstream out(filename);
         if (!out) throw std::runtime_error("Cannot open file for writing");
@@ -175,9 +651,9 @@ public:
         out << "MapSparseMatrix\n";
         out << rows << " " << cols << "\n";
         out << data.size() << "\n";
-        for (const auto& entry : data) {
-            out << entry.first.first << " " << entry.first.second << " " << entry.second << "\n";
-        }
+        data.forEach([&out](size_t row, size_t col, const T& value) {
+            out << row << " " << col << " " << value << "\n";
+        });
     }
     
     void loadFromFile(const std::string& filename) override {
@@ -199,7 +675,7 @@ public:
             size_t row, col;
             T val;
             in >> row >> col >> val;
-            data[{row, col}] = val;
+            data.insert(row, col, val);
         }
     }
     
@@ -210,32 +686,246 @@ public:
         
         size_t totalElements = r * c;
         size_t count = static_cast<size_t>(totalElements * density);
+        data.reserve(count);
         
         for (size_t i = 0; i < count; ++i) {
             size_t row = rand() % r;
             size_t col = rand() % c;
-            data[{row, col}] = generator();
+            data.insert(row, col, generator());
         }
     }
 };
 
-template<typename T>
+// Індекси стовпців можна додатково стиснути compressIndices(): для кожного рядка зберігається
+// перший стовпець, а далі різниці сусідніх стовпців у форматі varint (7 біт на байт, старший
+// біт - ознака продовження). У стрічкових і блочних матрицях різниці малі й займають 1 байт
+// замість 4-8. multiplyVector, get і forEachStored декодують їх на льоту; ітератори, row() і rowDot
+// потребують розпакованих індексів.
+//
+// Значення можна зберігати з меншою точністю (Value = float або BFloat16 при T = double):
+// multiplyVector читає вдвічі-вчетверо менше байтів значень, а накопичує суму в T.
+// Ітератори, row() і rowDot видають посилання на T, а CSC зберігає значення в T, тому вони
+// доступні лише при Value = T.
+template<typename T, typename Index, typename Value>
 class CSRSparseMatrix : public SparseMatrix<T> {
+    static_assert(std::is_unsigned<Index>::value, "CSR index type must be unsigned");
+    
+    template<typename, typename, typename> friend class CSRSparseMatrix;
+    
 private:
-    std::vector<T> values;
-    std::vector<size_t> colIndices;
-    std::vector<size_t> rowPointers;
+    std::vector<Value> values;
+    std::vector<Index> colIndices;
+    std::vector<Index> rowPointers;
+    
+    // Стиснуті індекси: перший стовпець рядка i - firstColumns[i], різниці решти починаються
+    // з байта packedRowOffsets[i]
+    std::vector<uint8_t> packedColumns;
+    std::vector<Index> packedRowOffsets;
+    std::vector<Index> firstColumns;
+    bool indicesCompressed = false;
     
     using SparseMatrix<T>::rows;
     using SparseMatrix<T>::cols;
     using SparseMatrix<T>::defaultValue;
     
+    void requireUncompressed() const {
+        if (indicesCompressed) {
+            throw std::runtime_error("CSR column indices are compressed - call decompressIndices() first");
+        }
+    }
+    
+    static void writeVarint(std::vector<uint8_t>& out, size_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+    
+    // Декодує одне значення й зсуває p; однобайтове значення (різниця до 127) - швидкий шлях
+    static size_t readVarint(const uint8_t*& p) {
+        size_t value = *p++;
+        if (value < 0x80) return value;
+        value &= 0x7F;
+        unsigned shift = 7;
+        while (true) {
+            size_t byte = *p++;
+            value |= (byte & 0x7F) << shift;
+            if (byte < 0x80) return value;
+            shift += 7;
+        }
+    }
+    
+    // Декодує стиснуті стовпці рядка i, викликаючи visit(j, col) для кожної позиції j.
+    // Якщо всі різниці рядка однобайтові (байтів на один менше, ніж елементів), цикл без розгалужень
+    template<typename Visit>
+    void decodeRow(size_t i, Visit visit) const {
+        size_t start = rowPointers[i];
+        size_t end = rowPointers[i + 1];
+        if (start == end) return;
+        
+        const uint8_t* p = packedColumns.data() + packedRowOffsets[i];
+        size_t col = firstColumns[i];
+        visit(start, col);
+        if (size_t(packedRowOffsets[i + 1] - packedRowOffsets[i]) == end - start - 1) {
+            for (size_t j = start + 1; j < end; ++j) {
+                col += p[j - start - 1];
+                visit(j, col);
+            }
+        } else {
+            for (size_t j = start + 1; j < end; ++j) {
+                col += readVarint(p);
+                visit(j, col);
+            }
+        }
+    }
+    
+    // Індекси стовпців у звичайному вигляді: власні або розпаковані в scratch
+    const std::vector<Index>& columnIndices(std::vector<Index>& scratch) const {
+        if (!indicesCompressed) return colIndices;
+        
+        scratch.resize(values.size());
+        for (size_t i = 0; i < rows; ++i) {
+            decodeRow(i, [&scratch](size_t j, size_t col) { scratch[j] = static_cast<Index>(col); });
+        }
+        return scratch;
+    }
+    
+    // y[i] = (A * x)[i] для рядків [from, to); стиснуті індекси декодуються на льоту разом зі значеннями
+    void multiplyRows(size_t from, size_t to, const T* x, T* y) const {
+        if (indicesCompressed) {
+            for (size_t i = from; i < to; ++i) {
+                T sum = defaultValue;
+                decodeRow(i, [&](size_t j, size_t col) { sum = sum + static_cast<T>(values[j]) * x[col]; });
+                y[i] = sum;
+            }
+            return;
+        }
+        
+        for (size_t i = from; i < to; ++i) {
+            T sum = defaultValue;
+            size_t end = rowPointers[i + 1];
+            for (size_t j = rowPointers[i]; j < end; ++j) {
+                sum = sum + static_cast<T>(values[j]) * x[colIndices[j]];
+            }
+            y[i] = sum;
+        }
+    }
+    
+    // Y = A * X для k векторів у построковому розміщенні. При K > 0 (k відоме під час компіляції)
+    // рядок Y накопичується в локальному масиві, і цикл по векторах розгортається й векторизується;
+    // K == 0 - довільне k, накопичення прямо в Y. Матриця читається один раз на весь блок.
+    template<size_t K>
+    void multiplyDenseRows(const T* X, size_t k, T* Y) const {
+        for (size_t i = 0; i < rows; ++i) {
+            if constexpr (K > 0) {
+                T acc[K];
+                for (size_t c = 0; c < K; ++c) acc[c] = defaultValue;
+                auto accumulate = [&](size_t j, size_t col) {
+                    T a = static_cast<T>(values[j]);
+                    const T* x = X + col * K;
+                    for (size_t c = 0; c < K; ++c) acc[c] = acc[c] + a * x[c];
+                };
+                if (indicesCompressed) {
+                    decodeRow(i, accumulate);
+                } else {
+                    for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) accumulate(j, colIndices[j]);
+                }
+                for (size_t c = 0; c < K; ++c) Y[i * K + c] = acc[c];
+            } else {
+                T* y = Y + i * k;
+                for (size_t c = 0; c < k; ++c) y[c] = defaultValue;
+                auto accumulate = [&](size_t j, size_t col) {
+                    T a = static_cast<T>(values[j]);
+                    const T* x = X + col * k;
+                    for (size_t c = 0; c < k; ++c) y[c] = y[c] + a * x[c];
+                };
+                if (indicesCompressed) {
+                    decodeRow(i, accumulate);
+                } else {
+                    for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) accumulate(j, colIndices[j]);
+                }
+            }
+        }
+    }
+    
 public:
+    // Ітератор по всіх збережених елементах у порядку (рядок, стовпець)
+    class const_iterator {
+    private:
+        const CSRSparseMatrix* matrix;
+        size_t position;
+        size_t row;
+        
+        void skipEmptyRows() {
+            while (row < matrix->rows && matrix->rowPointers[row + 1] <= position) ++row;
+        }
+    
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = MatrixEntry<T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = MatrixEntry<T>;
+        using pointer = void;
+        
+        const_iterator() : matrix(nullptr), position(0), row(0) {}
+        const_iterator(const CSRSparseMatrix* m, size_t pos) : matrix(m), position(pos), row(0) {
+            skipEmptyRows();
+        }
+        // Кінець діапазону: row = rows без обходу порожніх рядків
+        const_iterator(const CSRSparseMatrix* m, size_t pos, size_t rowPosition)
+            : matrix(m), position(pos), row(rowPosition) {}
+        
+        reference operator*() const {
+            return {row, matrix->colIndices[position], matrix->values[position]};
+        }
+        
+        const_iterator& operator++() {
+            ++position;
+            skipEmptyRows();
+            return *this;
+        }
+        
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+        
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+        bool operator!=(const const_iterator& other) const { return position != other.position; }
+    };
+    
+    using row_iterator = CompressedSliceIterator<T, Index>;
+    
+    // Чи вміщуються номери стовпців і кількість елементів у тип індексу
+    static bool indexFits(size_t c, size_t nnz) {
+        size_t limit = std::numeric_limits<Index>::max();
+        return c <= limit && nnz <= limit;
+    }
+    
     CSRSparseMatrix(size_t r = 0, size_t c = 0, const T& defVal = T())
         : SparseMatrix<T>(r, c, defVal) {
+        if (!indexFits(c, 0)) {
+            throw std::length_error("Matrix is too large for the CSR index type");
+        }
         rowPointers.resize(r + 1, 0);
     }
     
+    CSRSparseMatrix(size_t r, size_t c, std::vector<Value> vals, std::vector<Index> colIdx,
+                    std::vector<Index> rowPtrs, const T& defVal = T())
+        : SparseMatrix<T>(r, c, defVal), values(std::move(vals)),
+          colIndices(std::move(colIdx)), rowPointers(std::move(rowPtrs)) {
+        if (!indexFits(c, values.size())) {
+            throw std::length_error("Matrix is too large for the CSR index type");
+        }
+        if (rowPointers.size() != r + 1 || colIndices.size() != values.size() ||
+            rowPointers.back() != values.size()) {
+            throw std::invalid_argument("Inconsistent CSR arrays");
+        }
+    }
+    
     T get(size_t row, size_t col) const override {
         if (row >= rows || col >= cols) {
             throw std::out_of_range("Matrix index out of range");
@@ -244,16 +934,28 @@ public:
         size_t start = rowPointers[row];
         size_t end = rowPointers[row + 1];
         
+        // Стиснуті стовпці зростають, тож декодування зупиняється на першому не меншому за col
+        if (indicesCompressed) {
+            if (start == end) return defaultValue;
+            const uint8_t* p = packedColumns.data() + packedRowOffsets[row];
+            size_t current = firstColumns[row];
+            for (size_t i = start; i < end; ++i) {
+                if (i > start) current += readVarint(p);
+                if (current >= col) return current == col ? static_cast<T>(values[i]) : defaultValue;
+            }
+            return defaultValue;
+        }
+        
         for (size_t i = start; i < end; ++i) {
             if (colIndices[i] == col) {
-                return values[i];
+                return static_cast<T>(values[i]);
             }
         }
         
         return defaultValue;
     }
     
-    void set(size_t row, size_t col, const T& value) override {
+    void set(size_t /*row*/, size_t /*col*/, const T& /*value*/) override {
         throw std::runtime_error("CSR set not implemented - use for read-only operations");
     }
     
@@ -261,52 +963,323 @@ public:
         return values.size();
     }
     
-    std::string toString() const override {
-        std::ostringstream oss;
-        oss << "CSRSparseMatrix[" << rows << "x" << cols << ", stored=" << values.size() << "]";
-        return oss.str();
-    }
-    
-    void clear() override {
-        values.clear();
-        colIndices.clear();
-        rowPointers.assign(rows + 1, 0);
-    }
-    
-    SparseMatrix<T>* add(const SparseMatrix<T>& other) const override {
-        throw std::runtime_error("CSR operations not fully implemented");
-    }
-    
-    SparseMatrix<T>* multiply(const SparseMatrix<T>& other) const override {
-        throw std::runtime_error("CSR operations not fully implemented");
-    }
-    
-    std::vector<T> multiplyVector(const std::vector<T>& vec) const override {
-        if (cols != vec.size()) {
-            throw std::invalid_argument("Vector size must match matrix columns");
-        }
+    // Стискає індекси стовпців і звільняє colIndices; стовпці в кожному рядку мають строго зростати
+    void compressIndices() {
+        if (indicesCompressed) return;
         
-        std::vector<T> result(rows, defaultValue);
+        std::vector<uint8_t> packed;
+        std::vector<Index> offsets(rows + 1, 0);
+        std::vector<Index> first(rows, 0);
+        packed.reserve(values.size());
         for (size_t i = 0; i < rows; ++i) {
-            T sum = defaultValue;
             size_t start = rowPointers[i];
-            size_t end = rowPointers[i + 1];
-            
-            for (size_t j = start; j < end; ++j) {
-                sum = sum + values[j] * vec[colIndices[j]];
+            if (start < rowPointers[i + 1]) first[i] = colIndices[start];
+            for (size_t j = start + 1; j < rowPointers[i + 1]; ++j) {
+                if (colIndices[j] <= colIndices[j - 1]) {
+                    throw std::invalid_argument("CSR columns must be strictly increasing within each row");
+                }
+                writeVarint(packed, colIndices[j] - colIndices[j - 1]);
             }
-            result[i] = sum;
+            if (packed.size() > std::numeric_limits<Index>::max()) {
+                throw std::length_error("Compressed indices are too large for the CSR index type");
+            }
+            offsets[i + 1] = static_cast<Index>(packed.size());
         }
         
-        return result;
+        packed.shrink_to_fit();
+        packedColumns = std::move(packed);
+        packedRowOffsets = std::move(offsets);
+        firstColumns = std::move(first);
+        std::vector<Index>().swap(colIndices);
+        indicesCompressed = true;
     }
     
-    SparseMatrix<T>* transpose() const override {
-        throw std::runtime_error("CSR transpose not implemented");
+    void decompressIndices() {
+        if (!indicesCompressed) return;
+        
+        std::vector<Index> decoded;
+        columnIndices(decoded);
+        colIndices = std::move(decoded);
+        std::vector<uint8_t>().swap(packedColumns);
+        std::vector<Index>().swap(packedRowOffsets);
+        std::vector<Index>().swap(firstColumns);
+        indicesCompressed = false;
     }
     
-    void saveToFile(const std::string& filename) const override {
-        std::ofstream out(filename);
+    bool hasCompressedIndices() const {
+        return indicesCompressed;
+    }
+    
+    // Обсяг індексних масивів у байтах (без значень)
+    size_t indexMemoryBytes() const {
+        return (rowPointers.size() + colIndices.size() + packedRowOffsets.size() + firstColumns.size()) *
+               sizeof(Index) + packedColumns.size();
+    }
+    
+    size_t valueMemoryBytes() const {
+        return values.size() * sizeof(Value);
+    }
+    
+    const_iterator begin() const {
+        static_assert(std::is_same<Value, T>::value, "CSR iterators require values stored as T");
+        requireUncompressed();
+        return const_iterator(this, 0);
+    }
+    
+    const_iterator end() const {
+        static_assert(std::is_same<Value, T>::value, "CSR iterators require values stored as T");
+        requireUncompressed();
+        return const_iterator(this, values.size(), rows);
+    }
+    
+    // Збережені елементи рядка як діапазон (стовпець, значення) без копіювання
+    IteratorRange<row_iterator> row(size_t i) const {
+        static_assert(std::is_same<Value, T>::value, "CSR row views require values stored as T");
+        requireUncompressed();
+        if (i >= rows) {
+            throw std::out_of_range("Matrix row out of range");
+        }
+        size_t start = rowPointers[i];
+        size_t end = rowPointers[i + 1];
+        return IteratorRange<row_iterator>(row_iterator(colIndices.data() + start, values.data() + start),
+                                           row_iterator(colIndices.data() + end, values.data() + end));
+    }
+    
+    // Скалярний добуток рядка на розріджений вектор (відсортовані індекси) через адаптивний перетин
+    T rowDot(size_t row, const std::vector<size_t>& indices, const std::vector<T>& vals) const {
+        static_assert(std::is_same<Value, T>::value, "CSR rowDot requires values stored as T");
+        if (row >= rows) {
+            throw std::out_of_range("Matrix row out of range");
+        }
+        if (indices.size() != vals.size()) {
+            throw std::invalid_argument("Indices and values must have the same length");
+        }
+        requireUncompressed();
+        size_t start = rowPointers[row];
+        return sparseDot(colIndices.data() + start, values.data() + start, rowPointers[row + 1] - start,
+                         indices.data(), vals.data(), indices.size());
+    }
+    
+    // Скалярний добуток двох рядків - елемент A * A^T
+    T rowDot(size_t rowA, size_t rowB) const {
+        static_assert(std::is_same<Value, T>::value, "CSR rowDot requires values stored as T");
+        if (rowA >= rows || rowB >= rows) {
+            throw std::out_of_range("Matrix row out of range");
+        }
+        requireUncompressed();
+        size_t startA = rowPointers[rowA];
+        size_t startB = rowPointers[rowB];
+        return sparseDot(colIndices.data() + startA, values.data() + startA, rowPointers[rowA + 1] - startA,
+                         colIndices.data() + startB, values.data() + startB, rowPointers[rowB + 1] - startB);
+    }
+    
+    void forEachStored(std::function<void(size_t, size_t, const T&)> visitor) const override {
+        if (indicesCompressed) {
+            for (size_t i = 0; i < rows; ++i) {
+                decodeRow(i, [&](size_t j, size_t col) { visitor(i, col, static_cast<T>(values[j])); });
+            }
+            return;
+        }
+        
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+                visitor(i, colIndices[j], static_cast<T>(values[j]));
+            }
+        }
+    }
+    
+    std::string toString() const override {
+        std::ostringstream oss;
+        oss << "CSRSparseMatrix[" << rows << "x" << cols << ", stored=" << values.size()
+            << (indicesCompressed ? ", compressed indices" : "")
+            << (std::is_same<Value, T>::value ? "" : ", reduced precision values") << "]";
+        return oss.str();
+    }
+    
+    void clear() override {
+        values.clear();
+        colIndices.clear();
+        rowPointers.assign(rows + 1, 0);
+        packedColumns.clear();
+        packedRowOffsets.clear();
+        firstColumns.clear();
+        indicesCompressed = false;
+    }
+    
+    SparseMatrix<T>* add(const SparseMatrix<T>& /*other*/) const override {
+        throw std::runtime_error("CSR operations not fully implemented");
+    }
+    
+    SparseMatrix<T>* multiply(const SparseMatrix<T>& /*other*/) const override {
+        throw std::runtime_error("CSR operations not fully implemented");
+    }
+    
+    std::vector<T> multiplyVector(const std::vector<T>& vec) const override {
+        std::vector<T> result;
+        multiplyVectorInto(vec, result, 1);
+        return result;
+    }
+    
+    // Рядки діляться між потоками на діапазони з рівною кількістю елементів; result виділяється
+    // лише тоді, коли має інший розмір. Дрібні матриці не окупають запуск потоків і рахуються в одному
+    void multiplyVectorInto(const std::vector<T>& vec, std::vector<T>& result, unsigned threads = 0) const override {
+        if (cols != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix columns");
+        }
+        if (&vec == &result) {
+            throw std::invalid_argument("Result vector must not alias the input vector");
+        }
+        result.resize(rows);
+        
+        size_t nnz = values.size();
+        size_t workers = resolveThreadCount(threads);
+        workers = std::min(workers, std::max<size_t>(1, nnz / (size_t(1) << 15)));
+        if (workers <= 1) {
+            multiplyRows(0, rows, vec.data(), result.data());
+            return;
+        }
+        
+        // Перший рядок частини part - без тимчасового масиву меж
+        auto rowAt = [&](size_t part) -> size_t {
+            if (part == 0) return 0;
+            if (part == workers) return rows;
+            return std::upper_bound(rowPointers.begin(), rowPointers.end(), nnz / workers * part)
+                   - rowPointers.begin() - 1;
+        };
+        parallelForRange(0, workers, [&](size_t from, size_t to, unsigned) {
+            for (size_t t = from; t < to; ++t) multiplyRows(rowAt(t), rowAt(t + 1), vec.data(), result.data());
+        }, static_cast<unsigned>(workers));
+    }
+    
+    // Y = A * X для блоку з k векторів: X - cols x k, Y - rows x k, обидва построково
+    // (k значень одного рядка підряд), Y не має перекриватися з X. Стовпець c результату
+    // збігається з multiplyVector від стовпця c X.
+    void multiplyDense(const T* X, size_t k, T* Y) const {
+        switch (k) {
+            case 1: multiplyDenseRows<1>(X, k, Y); break;
+            case 2: multiplyDenseRows<2>(X, k, Y); break;
+            case 4: multiplyDenseRows<4>(X, k, Y); break;
+            case 8: multiplyDenseRows<8>(X, k, Y); break;
+            case 16: multiplyDenseRows<16>(X, k, Y); break;
+            case 32: multiplyDenseRows<32>(X, k, Y); break;
+            default: multiplyDenseRows<0>(X, k, Y); break;
+        }
+    }
+    
+    std::vector<T> multiplyDense(const std::vector<T>& X, size_t k) const {
+        if (X.size() != cols * k) {
+            throw std::invalid_argument("Block size must be matrix columns times vector count");
+        }
+        std::vector<T> Y(rows * k);
+        multiplyDense(X.data(), k, Y.data());
+        return Y;
+    }
+    
+    // A^T * x без побудови транспонованої матриці
+    std::vector<T> multiplyVectorTransposed(const std::vector<T>& vec, unsigned threads = 0) const {
+        if (rows != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix rows");
+        }
+        std::vector<Index> scratch;
+        std::vector<T> result;
+        compressedScatterMultiply(rows, cols, rowPointers, columnIndices(scratch), values, vec, result, threads);
+        return result;
+    }
+    
+    SparseMatrix<T>* transpose() const override {
+        return new CSRSparseMatrix<T, Index, Value>(transposed());
+    }
+    
+    // Ті самі дані по стовпцях; масиви CSC матриці A збігаються з масивами CSR матриці A^T
+    CSCSparseMatrix<T, Index> toCSC(unsigned threads = 0) const;
+    
+    // Транспонування сортуванням підрахунком: гістограма стовпців, префіксна сума, розкидання.
+    // Рядки діляться між потоками на діапазони з рівною кількістю елементів; кожен потік рахує
+    // власну гістограму, тож у розкиданні немає атомарних операцій, а рядки результату
+    // лишаються впорядкованими за стовпцем.
+    CSRSparseMatrix<T, Index, Value> transposed(unsigned threads = 0) const {
+        size_t nnz = values.size();
+        std::vector<Index> scratch;
+        const std::vector<Index>& colIdx = columnIndices(scratch);
+        
+        // Гістограми займають workers * cols; потоків не більше, ніж окупається розкиданням
+        size_t workers = resolveThreadCount(threads);
+        workers = std::min(workers, std::max<size_t>(1, nnz / (size_t(1) << 15)));
+        workers = std::min(workers, std::max<size_t>(1, 2 * nnz / std::max<size_t>(cols, 1)));
+        workers = std::min(workers, std::max<size_t>(rows, 1));
+        
+        std::vector<size_t> rowBegin(workers + 1, rows);
+        for (size_t t = 0; t < workers; ++t) {
+            size_t target = nnz / workers * t;
+            rowBegin[t] = std::upper_bound(rowPointers.begin(), rowPointers.end(), target) - rowPointers.begin() - 1;
+        }
+        rowBegin[0] = 0;
+        
+        std::vector<std::vector<size_t>> offsets(workers, std::vector<size_t>(cols, 0));
+        parallelForRange(0, workers, [&](size_t from, size_t to, unsigned) {
+            for (size_t t = from; t < to; ++t) {
+                size_t* counts = offsets[t].data();
+                for (size_t j = rowPointers[rowBegin[t]]; j < rowPointers[rowBegin[t + 1]]; ++j) {
+                    ++counts[colIdx[j]];
+                }
+            }
+        }, static_cast<unsigned>(workers));
+        
+        // Початок кожного стовпця, потім зсуви кожного потоку всередині стовпця
+        std::vector<Index> newRowPointers(cols + 1, 0);
+        for (size_t c = 0; c < cols; ++c) {
+            size_t total = 0;
+            for (size_t t = 0; t < workers; ++t) total += offsets[t][c];
+            newRowPointers[c + 1] = static_cast<Index>(newRowPointers[c] + total);
+        }
+        parallelForRange(0, cols, [&](size_t from, size_t to, unsigned) {
+            for (size_t c = from; c < to; ++c) {
+                size_t running = newRowPointers[c];
+                for (size_t t = 0; t < workers; ++t) {
+                    size_t count = offsets[t][c];
+                    offsets[t][c] = running;
+                    running += count;
+                }
+            }
+        }, static_cast<unsigned>(workers));
+        
+        std::vector<Value> newValues(nnz);
+        std::vector<Index> newColIndices(nnz);
+        parallelForRange(0, workers, [&](size_t from, size_t to, unsigned) {
+            for (size_t t = from; t < to; ++t) {
+                size_t* next = offsets[t].data();
+                for (size_t r = rowBegin[t]; r < rowBegin[t + 1]; ++r) {
+                    for (size_t j = rowPointers[r]; j < rowPointers[r + 1]; ++j) {
+                        size_t pos = next[colIdx[j]]++;
+                        newColIndices[pos] = static_cast<Index>(r);
+                        newValues[pos] = values[j];
+                    }
+                }
+            }
+        }, static_cast<unsigned>(workers));
+        
+        return CSRSparseMatrix<T, Index, Value>(cols, rows, std::move(newValues), std::move(newColIndices),
+                                                std::move(newRowPointers), defaultValue);
+    }
+    
+    // Копія зі значеннями, збереженими як Other (наприклад, toPrecision<float>() для T = double);
+    // стиснення індексів зберігається
+    template<typename Other>
+    CSRSparseMatrix<T, Index, Other> toPrecision() const {
+        CSRSparseMatrix<T, Index, Other> result(rows, cols, defaultValue);
+        result.values.reserve(values.size());
+        for (const auto& v : values) result.values.push_back(static_cast<Other>(static_cast<T>(v)));
+        result.colIndices = colIndices;
+        result.rowPointers = rowPointers;
+        result.packedColumns = packedColumns;
+        result.packedRowOffsets = packedRowOffsets;
+        result.firstColumns = firstColumns;
+        result.indicesCompressed = indicesCompressed;
+        return result;
+    }
+    
+    void saveToFile(const std::string& filename) const override {
+        std::ofstream out(filename);
         if (!out) throw std::runtime_error("Cannot open file for writing");
         
         out << "CSRSparseMatrix\n";
@@ -315,7 +1288,8 @@ public:
         
         for (const auto& v : values) out << v << " ";
         out << "\n";
-        for (const auto& c : colIndices) out << c << " ";
+        std::vector<Index> scratch;
+        for (const auto& c : columnIndices(scratch)) out << c << " ";
         out << "\n";
         for (const auto& r : rowPointers) out << r << " ";
         out << "\n";
@@ -331,9 +1305,16 @@ public:
         
         size_t r, c, count;
         in >> r >> c >> count;
+        if (!indexFits(c, count)) {
+            throw std::length_error("Matrix is too large for the CSR index type");
+        }
         
         rows = r;
         cols = c;
+        packedColumns.clear();
+        packedRowOffsets.clear();
+        firstColumns.clear();
+        indicesCompressed = false;
         
         values.resize(count);
         colIndices.resize(count);
@@ -345,4 +1326,573 @@ public:
     }
 };
 
+template<typename T, typename Index>
+class CSCSparseMatrix : public SparseMatrix<T> {
+    static_assert(std::is_unsigned<Index>::value, "CSC index type must be unsigned");
+    
+private:
+    std::vector<T> values;
+    std::vector<Index> rowIndices;
+    std::vector<Index> colPointers;
+    
+    using SparseMatrix<T>::rows;
+    using SparseMatrix<T>::cols;
+    using SparseMatrix<T>::defaultValue;
+    
+public:
+    // Ітератор по всіх збережених елементах у порядку (стовпець, рядок)
+    class const_iterator {
+    private:
+        const CSCSparseMatrix* matrix;
+        size_t position;
+        size_t col;
+        
+        void skipEmptyColumns() {
+            while (col < matrix->cols && matrix->colPointers[col + 1] <= position) ++col;
+        }
+    
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = MatrixEntry<T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = MatrixEntry<T>;
+        using pointer = void;
+        
+        const_iterator() : matrix(nullptr), position(0), col(0) {}
+        const_iterator(const CSCSparseMatrix* m, size_t pos) : matrix(m), position(pos), col(0) {
+            skipEmptyColumns();
+        }
+        // Кінець діапазону: col = cols без обходу порожніх стовпців
+        const_iterator(const CSCSparseMatrix* m, size_t pos, size_t colPosition)
+            : matrix(m), position(pos), col(colPosition) {}
+        
+        reference operator*() const {
+            return {matrix->rowIndices[position], col, matrix->values[position]};
+        }
+        
+        const_iterator& operator++() {
+            ++position;
+            skipEmptyColumns();
+            return *this;
+        }
+        
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+        
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+        bool operator!=(const const_iterator& other) const { return position != other.position; }
+    };
+    
+    using column_iterator = CompressedSliceIterator<T, Index>;
+    
+    // Чи вміщуються номери рядків і кількість елементів у тип індексу
+    static bool indexFits(size_t r, size_t nnz) {
+        size_t limit = std::numeric_limits<Index>::max();
+        return r <= limit && nnz <= limit;
+    }
+    
+    CSCSparseMatrix(size_t r = 0, size_t c = 0, const T& defVal = T())
+        : SparseMatrix<T>(r, c, defVal) {
+        if (!indexFits(r, 0)) {
+            throw std::length_error("Matrix is too large for the CSC index type");
+        }
+        colPointers.resize(c + 1, 0);
+    }
+    
+    CSCSparseMatrix(size_t r, size_t c, std::vector<T> vals, std::vector<Index> rowIdx,
+                    std::vector<Index> colPtrs, const T& defVal = T())
+        : SparseMatrix<T>(r, c, defVal), values(std::move(vals)),
+          rowIndices(std::move(rowIdx)), colPointers(std::move(colPtrs)) {
+        if (!indexFits(r, values.size())) {
+            throw std::length_error("Matrix is too large for the CSC index type");
+        }
+        if (colPointers.size() != c + 1 || rowIndices.size() != values.size() ||
+            colPointers.back() != values.size()) {
+            throw std::invalid_argument("Inconsistent CSC arrays");
+        }
+    }
+    
+    T get(size_t row, size_t col) const override {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("Matrix index out of range");
+        }
+        
+        auto first = rowIndices.begin() + colPointers[col];
+        auto last = rowIndices.begin() + colPointers[col + 1];
+        auto it = std::lower_bound(first, last, row);
+        return (it != last && *it == row) ? values[it - rowIndices.begin()] : defaultValue;
+    }
+    
+    void set(size_t /*row*/, size_t /*col*/, const T& /*value*/) override {
+        throw std::runtime_error("CSC set not implemented - use for read-only operations");
+    }
+    
+    size_t nonZeroCount() const override {
+        return values.size();
+    }
+    
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+    
+    const_iterator end() const {
+        return const_iterator(this, values.size(), cols);
+    }
+    
+    // Збережені елементи стовпця як діапазон (рядок, значення) без копіювання
+    IteratorRange<column_iterator> column(size_t j) const {
+        if (j >= cols) {
+            throw std::out_of_range("Matrix column out of range");
+        }
+        size_t start = colPointers[j];
+        size_t end = colPointers[j + 1];
+        return IteratorRange<column_iterator>(column_iterator(rowIndices.data() + start, values.data() + start),
+                                              column_iterator(rowIndices.data() + end, values.data() + end));
+    }
+    
+    void forEachStored(std::function<void(size_t, size_t, const T&)> visitor) const override {
+        for (size_t j = 0; j < cols; ++j) {
+            for (size_t k = colPointers[j]; k < colPointers[j + 1]; ++k) {
+                visitor(rowIndices[k], j, values[k]);
+            }
+        }
+    }
+    
+    std::string toString() const override {
+        std::ostringstream oss;
+        oss << "CSCSparseMatrix[" << rows << "x" << cols << ", stored=" << values.size() << "]";
+        return oss.str();
+    }
+    
+    void clear() override {
+        values.clear();
+        rowIndices.clear();
+        colPointers.assign(cols + 1, 0);
+    }
+    
+    SparseMatrix<T>* add(const SparseMatrix<T>& /*other*/) const override {
+        throw std::runtime_error("CSC operations not fully implemented");
+    }
+    
+    SparseMatrix<T>* multiply(const SparseMatrix<T>& /*other*/) const override {
+        throw std::runtime_error("CSC operations not fully implemented");
+    }
+    
+    // A * x: стовпці розкидаються в y, як у CSRSparseMatrix::multiplyVectorTransposed
+    std::vector<T> multiplyVector(const std::vector<T>& vec) const override {
+        return multiplyVector(vec, 0);
+    }
+    
+    std::vector<T> multiplyVector(const std::vector<T>& vec, unsigned threads) const {
+        std::vector<T> result;
+        multiplyVectorInto(vec, result, threads);
+        return result;
+    }
+    
+    void multiplyVectorInto(const std::vector<T>& vec, std::vector<T>& result, unsigned threads = 0) const override {
+        if (cols != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix columns");
+        }
+        if (&vec == &result) {
+            throw std::invalid_argument("Result vector must not alias the input vector");
+        }
+        compressedScatterMultiply(cols, rows, colPointers, rowIndices, values, vec, result, threads);
+    }
+    
+    // A^T * x: скалярний добуток кожного стовпця на x
+    std::vector<T> multiplyVectorTransposed(const std::vector<T>& vec) const {
+        if (rows != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix rows");
+        }
+        
+        std::vector<T> result(cols, T());
+        for (size_t j = 0; j < cols; ++j) {
+            result[j] = sparseDenseDot(rowIndices.data() + colPointers[j], values.data() + colPointers[j],
+                                       colPointers[j + 1] - colPointers[j], vec.data());
+        }
+        return result;
+    }
+    
+    // Транспонована CSC - це CSR з тими самими масивами
+    SparseMatrix<T>* transpose() const override {
+        return new CSRSparseMatrix<T, Index>(cols, rows, values, rowIndices, colPointers, defaultValue);
+    }
+    
+    CSRSparseMatrix<T, Index> toCSR(unsigned threads = 0) const {
+        return CSRSparseMatrix<T, Index>(cols, rows, values, rowIndices, colPointers, defaultValue).transposed(threads);
+    }
+    
+    void saveToFile(const std::string& filename) const override {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Cannot open file for writing");
+        
+        out << "CSCSparseMatrix\n";
+        out << rows << " " << cols << "\n";
+        out << values.size() << "\n";
+        
+        for (const auto& v : values) out << v << " ";
+        out << "\n";
+        for (const auto& r : rowIndices) out << r << " ";
+        out << "\n";
+        for (const auto& c : colPointers) out << c << " ";
+        out << "\n";
+    }
+    
+    void loadFromFile(const std::string& filename) override {
+        std::ifstream in(filename);
+        if (!in) throw std::runtime_error("Cannot open file for reading");
+        
+        std::string type;
+        in >> type;
+        if (type != "CSCSparseMatrix") throw std::runtime_error("Invalid file format");
+        
+        size_t r, c, count;
+        in >> r >> c >> count;
+        if (!indexFits(r, count)) {
+            throw std::length_error("Matrix is too large for the CSC index type");
+        }
+        
+        rows = r;
+        cols = c;
+        
+        values.resize(count);
+        rowIndices.resize(count);
+        colPointers.resize(c + 1);
+        
+        for (size_t i = 0; i < count; ++i) in >> values[i];
+        for (size_t i = 0; i < count; ++i) in >> rowIndices[i];
+        for (size_t i = 0; i < c + 1; ++i) in >> colPointers[i];
+    }
+};
+
+template<typename T, typename Index, typename Value>
+CSCSparseMatrix<T, Index> CSRSparseMatrix<T, Index, Value>::toCSC(unsigned threads) const {
+    static_assert(std::is_same<Value, T>::value, "CSC conversion requires values stored as T");
+    CSRSparseMatrix<T, Index> t = transposed(threads);
+    return CSCSparseMatrix<T, Index>(rows, cols, std::move(t.values), std::move(t.colIndices),
+                                     std::move(t.rowPointers), defaultValue);
+}
+
+template<typename T>
+using HashSparseMatrix = MapSparseMatrix<T, HashStorage<T>>;
+
+// y[0..BR) += B * x[0..BC) для щільного блоку BR x BC (по рядках).
+// Розмір блоку відомий під час компіляції, тож згортки розгортаються повністю, без циклів.
+template<typename T, size_t BR, size_t BC>
+struct BlockKernel {
+    static void multiplyAdd(const T* block, const T* x, T* y) {
+        multiplyAddRows(block, x, y, std::make_index_sequence<BR>());
+    }
+    
+private:
+    template<size_t... R>
+    static void multiplyAddRows(const T* block, const T* x, T* y, std::index_sequence<R...>) {
+        ((y[R] += rowDot<R>(block, x, std::make_index_sequence<BC>())), ...);
+    }
+    
+    template<size_t R, size_t... C>
+    static T rowDot(const T* block, const T* x, std::index_sequence<C...>) {
+        return ((block[R * BC + C] * x[C]) + ...);
+    }
+};
+
+// Блочний CSR: кожен збережений елемент - щільний блок BR x BC з одним індексом стовпця блоку.
+// Розміри матриці, не кратні блоку, доповнюються нулями до цілих блоків.
+template<typename T, size_t BR, size_t BC = BR>
+class BSRSparseMatrix : public SparseMatrix<T> {
+    static_assert(BR > 0 && BC > 0, "Block dimensions must be positive");
+    
+private:
+    static constexpr size_t BLOCK = BR * BC;
+    
+    size_t blockRows, blockCols;
+    std::vector<T> blockValues;
+    std::vector<size_t> blockColIndices;
+    std::vector<size_t> blockRowPointers;
+    
+    using SparseMatrix<T>::rows;
+    using SparseMatrix<T>::cols;
+    using SparseMatrix<T>::defaultValue;
+    
+    const T* findBlock(size_t blockRow, size_t blockCol) const {
+        auto first = blockColIndices.begin() + blockRowPointers[blockRow];
+        auto last = blockColIndices.begin() + blockRowPointers[blockRow + 1];
+        auto it = std::lower_bound(first, last, blockCol);
+        return (it != last && *it == blockCol) ? &blockValues[(it - blockColIndices.begin()) * BLOCK] : nullptr;
+    }
+    
+public:
+    BSRSparseMatrix(size_t r = 0, size_t c = 0, const T& defVal = T())
+        : SparseMatrix<T>(r, c, defVal), blockRows((r + BR - 1) / BR), blockCols((c + BC - 1) / BC),
+          blockRowPointers(blockRows + 1, 0) {}
+    
+    BSRSparseMatrix(size_t r, size_t c, std::vector<T> vals, std::vector<size_t> blockColIdx,
+                    std::vector<size_t> blockRowPtrs, const T& defVal = T())
+        : SparseMatrix<T>(r, c, defVal), blockRows((r + BR - 1) / BR), blockCols((c + BC - 1) / BC),
+          blockValues(std::move(vals)), blockColIndices(std::move(blockColIdx)),
+          blockRowPointers(std::move(blockRowPtrs)) {
+        if (blockRowPointers.size() != blockRows + 1 || blockValues.size() != blockColIndices.size() * BLOCK ||
+            blockRowPointers.back() != blockColIndices.size()) {
+            throw std::invalid_argument("Inconsistent BSR arrays");
+        }
+    }
+    
+    // Перетворення з будь-якого формату: збережені елементи групуються в блоки, відсутні
+    // позиції всередині блоку заповнюються значенням за замовчуванням
+    explicit BSRSparseMatrix(const SparseMatrix<T>& source)
+        : BSRSparseMatrix(source.getRows(), source.getCols(), source.getDefaultValue()) {
+        std::vector<std::pair<std::pair<size_t, size_t>, std::pair<size_t, T>>> entries;
+        entries.reserve(source.nonZeroCount());
+        source.forEachStored([&entries](size_t row, size_t col, const T& value) {
+            entries.push_back({{row / BR, col / BC}, {(row % BR) * BC + col % BC, value}});
+        });
+        std::sort(entries.begin(), entries.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        
+        for (size_t k = 0; k < entries.size(); ++k) {
+            const auto& key = entries[k].first;
+            if (k == 0 || key != entries[k - 1].first) {
+                ++blockRowPointers[key.first + 1];
+                blockColIndices.push_back(key.second);
+                blockValues.resize(blockValues.size() + BLOCK, defaultValue);
+            }
+            blockValues[(blockColIndices.size() - 1) * BLOCK + entries[k].second.first] = entries[k].second.second;
+        }
+        for (size_t i = 0; i < blockRows; ++i) blockRowPointers[i + 1] += blockRowPointers[i];
+    }
+    
+    T get(size_t row, size_t col) const override {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("Matrix index out of range");
+        }
+        const T* block = findBlock(row / BR, col / BC);
+        return block ? block[(row % BR) * BC + col % BC] : defaultValue;
+    }
+    
+    void set(size_t /*row*/, size_t /*col*/, const T& /*value*/) override {
+        throw std::runtime_error("BSR set not implemented - use for read-only operations");
+    }
+    
+    // Лише значення, відмінні від значення за замовчуванням; заповнені нулями позиції блоків не рахуються
+    size_t nonZeroCount() const override {
+        size_t count = 0;
+        forEachStored([&count](size_t, size_t, const T&) { ++count; });
+        return count;
+    }
+    
+    size_t blockCount() const {
+        return blockColIndices.size();
+    }
+    
+    void forEachStored(std::function<void(size_t, size_t, const T&)> visitor) const override {
+        for (size_t br = 0; br < blockRows; ++br) {
+            for (size_t k = blockRowPointers[br]; k < blockRowPointers[br + 1]; ++k) {
+                const T* block = &blockValues[k * BLOCK];
+                for (size_t r = 0; r < BR && br * BR + r < rows; ++r) {
+                    for (size_t c = 0; c < BC && blockColIndices[k] * BC + c < cols; ++c) {
+                        if (!(block[r * BC + c] == defaultValue)) {
+                            visitor(br * BR + r, blockColIndices[k] * BC + c, block[r * BC + c]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    std::string toString() const override {
+        std::ostringstream oss;
+        oss << "BSRSparseMatrix<" << BR << "x" << BC << ">[" << rows << "x" << cols
+            << ", blocks=" << blockColIndices.size() << "]";
+        return oss.str();
+    }
+    
+    void clear() override {
+        blockValues.clear();
+        blockColIndices.clear();
+        blockRowPointers.assign(blockRows + 1, 0);
+    }
+    
+    SparseMatrix<T>* add(const SparseMatrix<T>& /*other*/) const override {
+        throw std::runtime_error("BSR operations not fully implemented");
+    }
+    
+    SparseMatrix<T>* multiply(const SparseMatrix<T>& /*other*/) const override {
+        throw std::runtime_error("BSR operations not fully implemented");
+    }
+    
+    // Один індекс стовпця на блок; локальний результат рядка блоків накопичується в регістрах
+    std::vector<T> multiplyVector(const std::vector<T>& vec) const override {
+        if (cols != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix columns");
+        }
+        
+        // Доповнення до цілих блоків, щоб ядро не виходило за межі x і y
+        const T* x = vec.data();
+        std::vector<T> paddedX;
+        if (cols % BC != 0) {
+            paddedX.assign(blockCols * BC, T());
+            std::copy(vec.begin(), vec.end(), paddedX.begin());
+            x = paddedX.data();
+        }
+        
+        std::vector<T> result(blockRows * BR, T());
+        for (size_t br = 0; br < blockRows; ++br) {
+            T local[BR] = {};
+            for (size_t k = blockRowPointers[br]; k < blockRowPointers[br + 1]; ++k) {
+                BlockKernel<T, BR, BC>::multiplyAdd(&blockValues[k * BLOCK], x + blockColIndices[k] * BC, local);
+            }
+            std::copy(local, local + BR, result.begin() + br * BR);
+        }
+        result.resize(rows);
+        return result;
+    }
+    
+    // Транспонування підрахунком по стовпцях блоків; кожен блок транспонується на місці призначення
+    SparseMatrix<T>* transpose() const override {
+        size_t count = blockColIndices.size();
+        std::vector<size_t> newRowPointers(blockCols + 1, 0);
+        for (size_t bc : blockColIndices) ++newRowPointers[bc + 1];
+        for (size_t i = 0; i < blockCols; ++i) newRowPointers[i + 1] += newRowPointers[i];
+        
+        std::vector<size_t> next(newRowPointers.begin(), newRowPointers.end() - 1);
+        std::vector<size_t> newColIndices(count);
+        std::vector<T> newValues(count * BLOCK);
+        for (size_t br = 0; br < blockRows; ++br) {
+            for (size_t k = blockRowPointers[br]; k < blockRowPointers[br + 1]; ++k) {
+                size_t pos = next[blockColIndices[k]]++;
+                newColIndices[pos] = br;
+                for (size_t r = 0; r < BR; ++r) {
+                    for (size_t c = 0; c < BC; ++c) {
+                        newValues[pos * BLOCK + c * BR + r] = blockValues[k * BLOCK + r * BC + c];
+                    }
+                }
+            }
+        }
+        return new BSRSparseMatrix<T, BC, BR>(cols, rows, std::move(newValues), std::move(newColIndices),
+                                              std::move(newRowPointers), defaultValue);
+    }
+    
+    void saveToFile(const std::string& filename) const override {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Cannot open file for writing");
+        
+        out << "BSRSparseMatrix\n";
+        out << BR << " " << BC << "\n";
+        out << rows << " " << cols << "\n";
+        out << blockColIndices.size() << "\n";
+        
+        for (const auto& v : blockValues) out << v << " ";
+        out << "\n";
+        for (const auto& c : blockColIndices) out << c << " ";
+        out << "\n";
+        for (const auto& r : blockRowPointers) out << r << " ";
+        out << "\n";
+    }
+    
+    void loadFromFile(const std::string& filename) override {
+        std::ifstream in(filename);
+        if (!in) throw std::runtime_error("Cannot open file for reading");
+        
+        std::string type;
+        in >> type;
+        if (type != "BSRSparseMatrix") throw std::runtime_error("Invalid file format");
+        
+        size_t br, bc, r, c, count;
+        in >> br >> bc >> r >> c >> count;
+        if (br != BR || bc != BC) throw std::runtime_error("Block size mismatch");
+        
+        rows = r;
+        cols = c;
+        blockRows = (r + BR - 1) / BR;
+        blockCols = (c + BC - 1) / BC;
+        
+        blockValues.resize(count * BLOCK);
+        blockColIndices.resize(count);
+        blockRowPointers.resize(blockRows + 1);
+        
+        for (size_t i = 0; i < count * BLOCK; ++i) in >> blockValues[i];
+        for (size_t i = 0; i < count; ++i) in >> blockColIndices[i];
+        for (size_t i = 0; i < blockRows + 1; ++i) in >> blockRowPointers[i];
+    }
+};
+
+// Найбільший розмір квадратного блоку з candidates (розміри матриці мають бути кратні йому),
+// для якого частка заповнених позицій у зайнятих блоках не менша за minFill; 1 - блочної структури немає
+template<typename T>
+size_t detectBlockSize(const SparseMatrix<T>& matrix, const std::vector<size_t>& candidates = {6, 4, 3, 2},
+                       double minFill = 0.9) {
+    size_t nnz = matrix.nonZeroCount();
+    if (nnz == 0) return 1;
+    
+    std::vector<std::pair<size_t, size_t>> positions;
+    positions.reserve(nnz);
+    matrix.forEachStored([&positions](size_t row, size_t col, const T&) { positions.push_back({row, col}); });
+    
+    size_t best = 1;
+    std::vector<std::pair<size_t, size_t>> blocks;
+    for (size_t b : candidates) {
+        if (b <= best || matrix.getRows() % b != 0 || matrix.getCols() % b != 0) continue;
+        blocks.clear();
+        for (const auto& pos : positions) blocks.push_back({pos.first / b, pos.second / b});
+        std::sort(blocks.begin(), blocks.end());
+        size_t blockCount = std::unique(blocks.begin(), blocks.end()) - blocks.begin();
+        if (static_cast<double>(nnz) / (blockCount * b * b) >= minFill) best = b;
+    }
+    return best;
+}
+
+// CSR з довільної матриці: збережені елементи сортуються за (рядок, стовпець)
+template<typename Index, typename T>
+CSRSparseMatrix<T, Index> buildCSR(const SparseMatrix<T>& matrix) {
+    if (!CSRSparseMatrix<T, Index>::indexFits(matrix.getCols(), matrix.nonZeroCount())) {
+        throw std::length_error("Matrix is too large for the CSR index type");
+    }
+    
+    std::vector<std::pair<std::pair<size_t, size_t>, T>> entries;
+    entries.reserve(matrix.nonZeroCount());
+    matrix.forEachStored([&entries](size_t row, size_t col, const T& value) {
+        entries.push_back({{row, col}, value});
+    });
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    
+    std::vector<T> values;
+    std::vector<Index> colIndices;
+    std::vector<Index> rowPointers(matrix.getRows() + 1, 0);
+    for (const auto& entry : entries) {
+        ++rowPointers[entry.first.first + 1];
+        colIndices.push_back(static_cast<Index>(entry.first.second));
+        values.push_back(entry.second);
+    }
+    for (size_t i = 0; i < matrix.getRows(); ++i) rowPointers[i + 1] += rowPointers[i];
+    return CSRSparseMatrix<T, Index>(matrix.getRows(), matrix.getCols(), std::move(values),
+                                     std::move(colIndices), std::move(rowPointers), matrix.getDefaultValue());
+}
+
+// CSR з 32-бітними індексами, якщо матриця в них вміщується, інакше з size_t
+template<typename T>
+std::unique_ptr<SparseMatrix<T>> makeCompactCSR(const SparseMatrix<T>& matrix) {
+    if (CSRSparseMatrix<T, uint32_t>::indexFits(matrix.getCols(), matrix.nonZeroCount())) {
+        return std::make_unique<CSRSparseMatrix<T, uint32_t>>(buildCSR<uint32_t>(matrix));
+    }
+    return std::make_unique<CSRSparseMatrix<T, size_t>>(buildCSR<size_t>(matrix));
+}
+
+// Вибирає формат за виявленою блочною структурою: BSR для блоків 2, 3, 4, 6, інакше makeCompactCSR
+template<typename T>
+std::unique_ptr<SparseMatrix<T>> makeBlockedMatrix(const SparseMatrix<T>& matrix, double minFill = 0.9) {
+    switch (detectBlockSize(matrix, {6, 4, 3, 2}, minFill)) {
+        case 6: return std::make_unique<BSRSparseMatrix<T, 6>>(matrix);
+        case 4: return std::make_unique<BSRSparseMatrix<T, 4>>(matrix);
+        case 3: return std::make_unique<BSRSparseMatrix<T, 3>>(matrix);
+        case 2: return std::make_unique<BSRSparseMatrix<T, 2>>(matrix);
+        default: break;
+    }
+    
+    return makeCompactCSR(matrix);
+}
+
 #endif
\ No newline at end of file
@@ -3,9 +3,17 @@
 #include <cstdlib>
 #include <ctime>
 #include <type_traits>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <random>
 #include "ISparseContainer.h"
 #include "SparseList.h"
+#include "ConcurrentSparseList.h"
+#include "LockFreeSparseList.h"
 #include "SparseMatrix.h"
+#include "MatrixReordering.h"
+#include "IterativeSolvers.h"
 #include "MathExpression.h"
 #include "MathFunction.h"
 #include "Sequence.h"
@@ -20,6 +28,14 @@ void demonstrateContainer(ISparseContainer<T>& container, const string& containe
     cout << "Size: " << container.size() << "\n";
     cout << "Non-zero elements: " << container.nonZeroCount() << "\n";
     
+    size_t shown = 0;
+    cout << "Stored entries:";
+    container.forEachStored([&shown](size_t index, const T& value) {
+        if (shown++ < 5) cout << " [" << index << "]=" << value;
+    });
+    if (shown > 5) cout << " ...";
+    cout << "\n";
+    
     if (container.size() > 0) {
         T firstElem = container.get(0);
         int foundIndex = container.findByValue(firstElem);
@@ -72,6 +88,16 @@ void demonstrateSparseStructures() {
     doubleList.generateRandom(50, 0.15, []() { return (rand() % 1000) / 100.0; });
     demonstrateContainerNumeric(doubleList, "Sparse List (double)");
     
+    SparseList<double> otherList(50, 0.0);
+    otherList.generateRandom(50, 0.3, []() { return (rand() % 1000) / 100.0; });
+    cout << "dot(doubleList, otherList) = " << doubleList.dot(otherList) << "\n";
+    cout << "Norms of doubleList: L1 = " << doubleList.norm1() << ", L2 = " << doubleList.norm2()
+         << ", Linf = " << doubleList.normInf() << "\n";
+    cout << "Elementwise product stores " << doubleList.multiplyElementwise(otherList).nonZeroCount()
+         << " elements\n";
+    doubleList.axpy(-1.0, otherList);
+    cout << "After doubleList -= otherList: stored " << doubleList.nonZeroCount() << " elements\n";
+    
     
     MapSparseMatrix<int> matrix1(10, 10, 0);
     matrix1.generateRandom(10, 10, 0.2, []() { return rand() % 10 + 1; });
@@ -81,6 +107,34 @@ void demonstrateSparseStructures() {
     matrix2.generateRandom(10, 10, 0.2, []() { return rand() % 10 + 1; });
     cout << "\nMatrix 2:\n" << matrix2.toString();
     
+    size_t largeEntries = count_if(matrix1.begin(), matrix1.end(),
+                                   [](const MatrixEntry<int>& entry) { return entry.value > 5; });
+    cout << "Matrix 1 entries > 5: " << largeEntries << "\n";
+    
+    auto csr1 = matrix1.toCSR();
+    for (size_t i = 0; i < min(csr1.getRows(), size_t(3)); ++i) {
+        cout << "Row " << i << " (CSR view):";
+        for (const auto& entry : csr1.row(i)) {
+            cout << " (" << entry.index << ": " << entry.value << ")";
+        }
+        cout << "\n";
+    }
+    
+    CSCSparseMatrix<int> csc1 = csr1.toCSC();
+    vector<int> ones(matrix1.getRows(), 1);
+    auto columnSums = csr1.multiplyVectorTransposed(ones);
+    cout << "Column sums (A^T * 1): [";
+    for (size_t j = 0; j < columnSums.size(); ++j) {
+        if (j > 0) cout << ", ";
+        cout << columnSums[j];
+    }
+    cout << "]\n";
+    cout << "Column 0 (CSC view):";
+    for (const auto& entry : csc1.column(0)) {
+        cout << " (" << entry.index << ": " << entry.value << ")";
+    }
+    cout << "\n";
+    
     cout << "\n--- Matrix Addition ---\n";
     auto sumMatrix = unique_ptr<SparseMatrix<int>>(matrix1.add(matrix2));
     cout << sumMatrix->toString();
@@ -176,6 +230,11 @@ void demonstrateMathematicalAnalysis() {
         cout << rootFunc.toString() << "\n";
         double root = rootFunc.findRoot(3.0);
         cout << "Root found: " << root << " (expected ≈ 2.0)\n";
+        
+        auto allRoots = rootFunc.findAllRoots(-5, 5);
+        cout << "All roots on [-5, 5]:";
+        for (double r : allRoots) cout << " " << r;
+        cout << "\n";
     } catch (const exception& e) {
         cout << "Root finding error: " << e.what() << "\n";
     }
@@ -224,6 +283,7 @@ void demonstrateSequences() {
     );
     cout << harmonic.toString() << "\n";
     cout << "Partial sum (1 to 100): " << harmonic.partialSum(1, 100) << "\n";
+    cout << "Parallel partial sum (1 to 1000000): " << harmonic.partialSumParallel(1, 1000000) << "\n";
     
     arith.saveToFile("arithmetic_sequence.txt", 1, 20);
     cout << "\nArithmetic sequence saved to: arithmetic_sequence.txt\n";
@@ -312,6 +372,7 @@ void demonstratePolymorphism() {
     exporters.push_back(make_shared<MathematicaExporter>());
     exporters.push_back(make_shared<SymPyExporter>());
     exporters.push_back(make_shared<LaTeXExporter>());
+    exporters.push_back(make_shared<CCodeExporter>());
     
     cout << "Exporting " << func.toString() << " to different formats:\n";
     for (const auto& exporter : exporters) {
@@ -682,6 +743,637 @@ void runAllDemonstrations() {
     cout << "  - function_latex.tex\n";
 }
 
+// Змішане навантаження: readPercent% читань, решта - записи у випадкові індекси
+template<typename Container>
+double measureMixedThroughput(Container& container, size_t size, unsigned threads,
+                              size_t totalOps, int readPercent) {
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    vector<double> checksums(threads, 0.0);
+    size_t opsPerThread = totalOps / threads;
+    
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&container, &checksums, size, opsPerThread, readPercent, t]() {
+            mt19937_64 rng(12345 + t);
+            uniform_int_distribution<size_t> index(0, size - 1);
+            uniform_int_distribution<int> percent(0, 99);
+            double sink = 0;
+            for (size_t i = 0; i < opsPerThread; ++i) {
+                size_t idx = index(rng);
+                if (percent(rng) < readPercent) {
+                    sink += container.get(idx);
+                } else {
+                    container.set(idx, static_cast<double>(i % 100 + 1));
+                }
+            }
+            checksums[t] = sink;
+        });
+    }
+    for (auto& w : workers) w.join();
+    
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return (opsPerThread * threads) / seconds / 1e6;
+}
+
+// Звичайний SparseList під одним м'ютексом - базова лінія для порівняння
+class LockedSparseList {
+private:
+    SparseList<double> list;
+    mutable mutex guard;
+    
+public:
+    LockedSparseList(size_t size) : list(size, 0.0) {}
+    
+    double get(size_t index) const {
+        lock_guard<mutex> lock(guard);
+        return list.get(index);
+    }
+    
+    void set(size_t index, double value) {
+        lock_guard<mutex> lock(guard);
+        list.set(index, value);
+    }
+};
+
+void benchmarkConcurrentSparseList() {
+    cout << "\n=== Concurrent Sparse List (90% reads / 10% writes) ===\n";
+    const size_t size = 1000000;
+    const size_t totalOps = 2000000;
+    
+    cout << "Threads\tLocked SparseList, Mops/s\tConcurrentSparseList, Mops/s\n";
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        LockedSparseList locked(size);
+        ConcurrentSparseList<double> concurrent(size, 0.0);
+        double lockedRate = measureMixedThroughput(locked, size, threads, totalOps, 90);
+        double concurrentRate = measureMixedThroughput(concurrent, size, threads, totalOps, 90);
+        cout << threads << "\t" << lockedRate << "\t\t\t\t" << concurrentRate << "\n";
+    }
+    cout << "Hardware threads available: " << thread::hardware_concurrency() << "\n";
+}
+
+void benchmarkLockFreeAccumulation() {
+    cout << "\n=== Parallel accumulation (value[i] += 1 on random indices) ===\n";
+    const size_t size = 1000000;
+    const size_t distinct = 50000;
+    const size_t totalOps = 2000000;
+    
+    cout << "Threads\tConcurrentSparseList, Mops/s\tLockFreeSparseList, Mops/s\n";
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u}) {
+        ConcurrentSparseList<double> sharded(size, 0.0);
+        LockFreeSparseList<double> lockFree(size, 0.0, distinct);
+        
+        auto run = [&](auto op) {
+            auto start = chrono::steady_clock::now();
+            vector<thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t]() {
+                    mt19937_64 rng(777 + t);
+                    uniform_int_distribution<size_t> index(0, distinct - 1);
+                    for (size_t i = 0; i < totalOps / threads; ++i) {
+                        op(index(rng) * (size / distinct));
+                    }
+                });
+            }
+            for (auto& w : workers) w.join();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            return (totalOps / threads) * threads / seconds / 1e6;
+        };
+        
+        double shardedRate = run([&](size_t idx) { sharded.add(idx, 1.0); });
+        double lockFreeRate = run([&](size_t idx) { lockFree.add(idx, 1.0); });
+        
+        lockFree.freeze();
+        cout << threads << "\t" << shardedRate << "\t\t\t\t" << lockFreeRate
+             << "\t(stored " << lockFree.nonZeroCount() << ")\n";
+    }
+}
+
+template<typename Matrix>
+double measureAssembly(Matrix& matrix, size_t n, size_t entries) {
+    mt19937_64 rng(42);
+    uniform_int_distribution<size_t> index(0, n - 1);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < entries; ++i) {
+        size_t r = index(rng), c = index(rng);
+        matrix.set(r, c, matrix.get(r, c) + 1.0);
+    }
+    auto csr = matrix.toCSR();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkMatrixAssembly() {
+    cout << "\n=== Random-access assembly (get + set, then toCSR) ===\n";
+    const size_t n = 100000;
+    const size_t entries = 1000000;
+    
+    MapSparseMatrix<double> tree(n, n, 0.0);
+    HashSparseMatrix<double> hash(n, n, 0.0);
+    cout << "MapSparseMatrix (std::map): " << measureAssembly(tree, n, entries) << " s\n";
+    cout << "HashSparseMatrix (flat hash): " << measureAssembly(hash, n, entries) << " s\n";
+}
+
+template<typename Op>
+double measureSeconds(Op op) {
+    auto start = chrono::steady_clock::now();
+    op();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Обидва шляхи йдуть через ISparseContainer: поелементні set()/get() проти setBatch()/gatherBatch()
+void benchmarkBatchAccess() {
+    cout << "\n=== Bulk load and gather through ISparseContainer (SparseList<double>) ===\n";
+    const size_t size = 10000000;
+    const size_t count = 2000000;
+    
+    mt19937_64 rng(2024);
+    uniform_int_distribution<size_t> index(0, size - 1);
+    vector<size_t> indices(count);
+    vector<double> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        indices[i] = index(rng);
+        values[i] = static_cast<double>(i % 100 + 1);
+    }
+    
+    cout << count << " indices in a list of " << size << "\n";
+    cout << "Indices\tset(), s\tsetBatch(), s\tget(), s\tgatherBatch(), s\n";
+    for (bool sorted : {false, true}) {
+        if (sorted) sort(indices.begin(), indices.end());
+        
+        SparseList<double> perElement(size, 0.0);
+        SparseList<double> batched(size, 0.0);
+        ISparseContainer<double>& single = perElement;
+        ISparseContainer<double>& bulk = batched;
+        vector<double> singleOut(count), bulkOut;
+        
+        double setTime = measureSeconds([&]() {
+            for (size_t i = 0; i < count; ++i) single.set(indices[i], values[i]);
+        });
+        double setBatchTime = measureSeconds([&]() { bulk.setBatch(indices, values); });
+        double getTime = measureSeconds([&]() {
+            for (size_t i = 0; i < count; ++i) singleOut[i] = single.get(indices[i]);
+        });
+        double gatherTime = measureSeconds([&]() { bulk.gatherBatch(indices, bulkOut); });
+        
+        cout << (sorted ? "sorted" : "random") << "\t" << setTime << "\t" << setBatchTime << "\t"
+             << getTime << "\t" << gatherTime << (singleOut == bulkOut ? "" : "\t(MISMATCH)") << "\n";
+    }
+}
+
+// Скалярний добуток двох розріджених векторів за різних співвідношень щільностей:
+// через get() по всіх індексах, SparseList::dot і ядра перетину над упакованими масивами
+void benchmarkSparseDot() {
+    cout << "\n=== Sparse dot product (n = 1000000) ===\n";
+    const size_t n = 1000000;
+    mt19937_64 rng(99);
+    uniform_real_distribution<double> value(-1.0, 1.0);
+    
+    auto randomList = [&](double density) {
+        SparseList<double> list(n, 0.0);
+        bernoulli_distribution keep(density);
+        for (size_t i = 0; i < n; ++i) {
+            if (keep(rng)) list.set(i, value(rng));
+        }
+        return list;
+    };
+    
+    cout << "nnz A\tnnz B\tget() loop, ms\tSparseList::dot\tmerge\tblock\tgalloping\tadaptive, ms\n";
+    const pair<double, double> densities[] = {
+        {0.01, 0.0001}, {0.01, 0.001}, {0.01, 0.01}, {0.01, 0.05}, {0.01, 0.1}, {0.01, 0.5}, {0.0001, 0.1}
+    };
+    for (const auto& density : densities) {
+        SparseList<double> a = randomList(density.first);
+        SparseList<double> b = randomList(density.second);
+        vector<size_t> ia, ib;
+        vector<double> va, vb;
+        a.pack(ia, va);
+        b.pack(ib, vb);
+        
+        // Окремі алгоритми перетину очікують коротший масив першим
+        bool aShorter = ia.size() <= ib.size();
+        const vector<size_t>& si = aShorter ? ia : ib;
+        const vector<double>& sv = aShorter ? va : vb;
+        const vector<size_t>& li = aShorter ? ib : ia;
+        const vector<double>& lv = aShorter ? vb : va;
+        
+        double reference = 0;
+        double getTime = measureSeconds([&]() {
+            for (size_t i = 0; i < n; ++i) reference += a.get(i) * b.get(i);
+        });
+        
+        bool agree = true;
+        auto timeKernel = [&](auto intersect) {
+            double sum = 0;
+            double seconds = measureSeconds([&]() {
+                intersect(si.data(), si.size(), li.data(), li.size(),
+                          [&sum, &sv, &lv](size_t i, size_t j) { sum += sv[i] * lv[j]; });
+            });
+            if (fabs(sum - reference) > 1e-9) agree = false;
+            return seconds * 1e3;
+        };
+        
+        double listResult = 0;
+        double listTime = measureSeconds([&]() { listResult = a.dot(b); }) * 1e3;
+        if (fabs(listResult - reference) > 1e-9) agree = false;
+        
+        double mergeTime = timeKernel([](auto... args) { mergeIntersect(args...); });
+        double blockTime = timeKernel([](auto... args) { blockIntersect(args...); });
+        double gallopTime = timeKernel([](auto... args) { gallopingIntersect(args...); });
+        double adaptiveTime = timeKernel([](auto... args) { intersectSorted(args...); });
+        
+        cout << ia.size() << "\t" << ib.size() << "\t" << getTime * 1e3 << "\t\t" << listTime << "\t\t"
+             << mergeTime << "\t" << blockTime << "\t" << gallopTime << "\t\t" << adaptiveTime
+             << (agree ? "" : "\t(MISMATCH)") << "\n";
+    }
+    
+    SparseList<double> a = randomList(0.01);
+    vector<size_t> ia;
+    vector<double> va;
+    a.pack(ia, va);
+    vector<double> dense(n);
+    for (auto& x : dense) x = value(rng);
+    
+    double denseResult = 0, packedResult = 0;
+    double tList = measureSeconds([&]() { denseResult = a.dot(dense); });
+    double tPacked = measureSeconds([&]() {
+        packedResult = sparseDenseDot(ia.data(), va.data(), ia.size(), dense.data());
+    });
+    cout << "Sparse-dense dot: SparseList " << tList * 1e3 << " ms, packed kernel " << tPacked * 1e3
+         << " ms" << (fabs(denseResult - packedResult) < 1e-9 ? "" : " (MISMATCH)") << "\n";
+}
+
+// Випадкова CSR-матриця з perRow елементами в кожному рядку
+template<typename Index = uint32_t>
+CSRSparseMatrix<double, Index> randomCSR(size_t rows, size_t cols, size_t perRow, unsigned seed) {
+    mt19937_64 rng(seed);
+    uniform_int_distribution<size_t> column(0, cols - 1);
+    vector<double> values;
+    vector<Index> colIndices;
+    vector<Index> rowPointers(rows + 1, 0);
+    values.reserve(rows * perRow);
+    colIndices.reserve(rows * perRow);
+    vector<size_t> rowCols;
+    for (size_t i = 0; i < rows; ++i) {
+        rowCols.clear();
+        for (size_t k = 0; k < perRow; ++k) rowCols.push_back(column(rng));
+        sort(rowCols.begin(), rowCols.end());
+        rowCols.erase(unique(rowCols.begin(), rowCols.end()), rowCols.end());
+        for (size_t c : rowCols) {
+            colIndices.push_back(static_cast<Index>(c));
+            values.push_back(static_cast<double>(i % 97 + 1));
+        }
+        rowPointers[i + 1] = static_cast<Index>(colIndices.size());
+    }
+    return CSRSparseMatrix<double, Index>(rows, cols, move(values), move(colIndices), move(rowPointers), 0.0);
+}
+
+void benchmarkTranspose() {
+    cout << "\n=== Transpose ===\n";
+    CSRSparseMatrix<double, uint32_t> csr = randomCSR(1000000, 1000000, 10, 7);
+    cout << "CSR " << csr.getRows() << "x" << csr.getCols() << ", nnz = " << csr.nonZeroCount() << "\n";
+    
+    unsigned hw = resolveThreadCount(0);
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        if (threads > hw && threads > 1) break;
+        CSRSparseMatrix<double, uint32_t> result;
+        double seconds = measureSeconds([&]() { result = csr.transposed(threads); });
+        cout << "CSR transposed(), " << threads << " thread(s): " << seconds << " s\n";
+    }
+    
+    vector<double> x(csr.getRows(), 1.0);
+    vector<double> viaTranspose, direct, viaCSC;
+    double transposeSeconds = measureSeconds([&]() { viaTranspose = csr.transposed().multiplyVector(x); });
+    double directSeconds = measureSeconds([&]() { direct = csr.multiplyVectorTransposed(x); });
+    CSCSparseMatrix<double, uint32_t> csc = csr.toCSC();
+    double cscSeconds = measureSeconds([&]() { viaCSC = csc.multiplyVectorTransposed(x); });
+    cout << "A^T * x: transpose + multiply " << transposeSeconds << " s, CSR multiplyVectorTransposed "
+         << directSeconds << " s, CSC " << cscSeconds << " s"
+         << (viaTranspose == direct && direct == viaCSC ? "" : " (MISMATCH)") << "\n";
+    
+    MapSparseMatrix<double> tree(100000, 100000, 0.0);
+    tree.generateRandom(100000, 100000, 0.00005, []() { return 1.0; });
+    double mapSeconds = measureSeconds([&]() { unique_ptr<SparseMatrix<double>> t(tree.transpose()); });
+    cout << "MapSparseMatrix transpose, nnz = " << tree.nonZeroCount() << ": " << mapSeconds << " s\n";
+}
+
+// Матриця "МСЕ": nodes вузлів, у кожного neighbours сусідів (разом із собою), кожен зв'язок - щільний блок b x b
+template<typename Index = uint32_t>
+CSRSparseMatrix<double, Index> randomBlockCSR(size_t nodes, size_t neighbours, size_t b, unsigned seed) {
+    mt19937_64 rng(seed);
+    uniform_int_distribution<size_t> node(0, nodes - 1);
+    uniform_real_distribution<double> value(-1.0, 1.0);
+    vector<double> values;
+    vector<Index> colIndices;
+    vector<Index> rowPointers(nodes * b + 1, 0);
+    vector<size_t> linked;
+    for (size_t i = 0; i < nodes; ++i) {
+        linked.assign(1, i);
+        while (linked.size() < neighbours) linked.push_back(node(rng));
+        sort(linked.begin(), linked.end());
+        linked.erase(unique(linked.begin(), linked.end()), linked.end());
+        for (size_t r = 0; r < b; ++r) {
+            for (size_t j : linked) {
+                for (size_t c = 0; c < b; ++c) {
+                    colIndices.push_back(static_cast<Index>(j * b + c));
+                    values.push_back(value(rng));
+                }
+            }
+            rowPointers[i * b + r + 1] = static_cast<Index>(colIndices.size());
+        }
+    }
+    return CSRSparseMatrix<double, Index>(nodes * b, nodes * b, move(values), move(colIndices), move(rowPointers), 0.0);
+}
+
+template<size_t B>
+void compareBlockSpMV(size_t nodes) {
+    CSRSparseMatrix<double, uint32_t> csr = randomBlockCSR(nodes, 9, B, 11);
+    cout << B << "x" << B << " blocks, " << csr.getRows() << " rows, nnz = " << csr.nonZeroCount()
+         << ", detected block size: " << detectBlockSize(csr) << "\n";
+    
+    BSRSparseMatrix<double, B> bsr(csr);
+    vector<double> x(csr.getCols());
+    for (size_t i = 0; i < x.size(); ++i) x[i] = 1.0 / (i % 13 + 1);
+    
+    const int repeats = 10;
+    vector<double> yCSR, yBSR;
+    double csrSeconds = measureSeconds([&]() {
+        for (int k = 0; k < repeats; ++k) yCSR = csr.multiplyVector(x);
+    });
+    double bsrSeconds = measureSeconds([&]() {
+        for (int k = 0; k < repeats; ++k) yBSR = bsr.multiplyVector(x);
+    });
+    double maxDiff = 0;
+    for (size_t i = 0; i < yCSR.size(); ++i) maxDiff = max(maxDiff, fabs(yCSR[i] - yBSR[i]));
+    cout << "  SpMV: CSR " << csrSeconds / repeats * 1e3 << " ms, BSR " << bsrSeconds / repeats * 1e3
+         << " ms, max difference " << maxDiff << "\n";
+}
+
+void benchmarkBlockSpMV() {
+    cout << "\n=== Block CSR (BSR) vs CSR SpMV ===\n";
+    compareBlockSpMV<3>(100000);
+    compareBlockSpMV<6>(30000);
+}
+
+template<typename Index>
+void measureIndexFormat(const char* label, const CSRSparseMatrix<double, Index>& csr, const vector<double>& x,
+                        const vector<double>& reference) {
+    const int repeats = 10;
+    vector<double> y;
+    double seconds = measureSeconds([&]() {
+        for (int k = 0; k < repeats; ++k) y = csr.multiplyVector(x);
+    });
+    cout << "  " << label << ": indices " << csr.indexMemoryBytes() / 1048576.0 << " MB, SpMV "
+         << seconds / repeats * 1e3 << " ms" << (y == reference ? "" : " (MISMATCH)") << "\n";
+}
+
+// Та сама матриця з індексами size_t, uint32_t і uint32_t зі стиснутими різницями стовпців
+void compareIndexFormats(const CSRSparseMatrix<double, uint32_t>& narrow) {
+    CSRSparseMatrix<double, size_t> wide = buildCSR<size_t>(narrow);
+    CSRSparseMatrix<double, uint32_t> packed = narrow;
+    packed.compressIndices();
+    
+    vector<double> x(narrow.getCols());
+    for (size_t i = 0; i < x.size(); ++i) x[i] = 1.0 / (i % 13 + 1);
+    vector<double> reference = wide.multiplyVector(x);
+    
+    measureIndexFormat("size_t", wide, x, reference);
+    measureIndexFormat("uint32_t", narrow, x, reference);
+    measureIndexFormat("uint32_t + varint deltas", packed, x, reference);
+}
+
+// Стрічкова матриця: 2 * halfWidth + 1 діагоналей із кроком stride
+CSRSparseMatrix<double, uint32_t> bandedCSR(size_t n, long halfWidth, long stride) {
+    vector<double> values;
+    vector<uint32_t> colIndices;
+    vector<uint32_t> rowPointers(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        for (long d = -halfWidth; d <= halfWidth; ++d) {
+            long j = static_cast<long>(i) + d * stride;
+            if (j < 0 || j >= static_cast<long>(n)) continue;
+            colIndices.push_back(static_cast<uint32_t>(j));
+            values.push_back(1.0 + d);
+        }
+        rowPointers[i + 1] = static_cast<uint32_t>(colIndices.size());
+    }
+    return CSRSparseMatrix<double, uint32_t>(n, n, move(values), move(colIndices), move(rowPointers), 0.0);
+}
+
+void benchmarkIndexCompression() {
+    cout << "\n=== CSR index storage ===\n";
+    cout << "Random 500000x500000, 10 per row:\n";
+    compareIndexFormats(randomCSR(500000, 500000, 10, 7));
+    cout << "FEM-like, 3x3 blocks, 100000 nodes:\n";
+    compareIndexFormats(randomBlockCSR(100000, 9, 3, 11));
+    cout << "Banded 2000000x2000000, 7 diagonals:\n";
+    compareIndexFormats(bandedCSR(2000000, 3, 2));
+}
+
+// Значення, збережені як Value: обсяг, час SpMV і відносна похибка ||y - y_double|| / ||y_double||
+template<typename Value>
+void measureValuePrecision(const char* label, const CSRSparseMatrix<double, uint32_t>& csr, const vector<double>& x,
+                           const vector<double>& reference) {
+    CSRSparseMatrix<double, uint32_t, Value> stored = csr.toPrecision<Value>();
+    const int repeats = 10;
+    vector<double> y;
+    double seconds = measureSeconds([&]() {
+        for (int k = 0; k < repeats; ++k) y = stored.multiplyVector(x);
+    });
+    
+    double errorSquares = 0, referenceSquares = 0;
+    for (size_t i = 0; i < y.size(); ++i) {
+        errorSquares += (y[i] - reference[i]) * (y[i] - reference[i]);
+        referenceSquares += reference[i] * reference[i];
+    }
+    cout << "  " << label << ": values " << stored.valueMemoryBytes() / 1048576.0 << " MB, SpMV "
+         << seconds / repeats * 1e3 << " ms, relative error " << sqrt(errorSquares / referenceSquares) << "\n";
+}
+
+void compareValuePrecisions(const CSRSparseMatrix<double, uint32_t>& csr) {
+    vector<double> x(csr.getCols());
+    for (size_t i = 0; i < x.size(); ++i) x[i] = 1.0 / (i % 13 + 1);
+    vector<double> reference = csr.multiplyVector(x);
+    
+    measureValuePrecision<double>("double", csr, x, reference);
+    measureValuePrecision<float>("float", csr, x, reference);
+    measureValuePrecision<BFloat16>("bfloat16", csr, x, reference);
+}
+
+void benchmarkMixedPrecision() {
+    cout << "\n=== CSR value storage precision (double accumulation) ===\n";
+    cout << "FEM-like, 3x3 blocks, 100000 nodes:\n";
+    compareValuePrecisions(randomBlockCSR(100000, 9, 3, 11));
+    cout << "FEM-like, 6x6 blocks, 30000 nodes:\n";
+    compareValuePrecisions(randomBlockCSR(30000, 9, 6, 11));
+}
+
+// 7-точковий оператор Лапласа на сітці n x n x n у природній нумерації. convection > 0 додає
+// перенесення вздовж x різницями проти потоку - матриця стає несиметричною
+CSRSparseMatrix<double, uint32_t> gridLaplacianCSR(size_t n, double convection = 0.0) {
+    vector<double> values;
+    vector<uint32_t> colIndices;
+    vector<uint32_t> rowPointers(n * n * n + 1, 0);
+    for (size_t z = 0; z < n; ++z) {
+        for (size_t y = 0; y < n; ++y) {
+            for (size_t x = 0; x < n; ++x) {
+                size_t i = (z * n + y) * n + x;
+                auto link = [&](bool inside, size_t j) {
+                    if (!inside) return;
+                    colIndices.push_back(static_cast<uint32_t>(j));
+                    values.push_back(j == i ? 6.0 + convection : (j + 1 == i ? -1.0 - convection : -1.0));
+                };
+                link(z > 0, i - n * n);
+                link(y > 0, i - n);
+                link(x > 0, i - 1);
+                link(true, i);
+                link(x + 1 < n, i + 1);
+                link(y + 1 < n, i + n);
+                link(z + 1 < n, i + n * n);
+                rowPointers[i + 1] = static_cast<uint32_t>(colIndices.size());
+            }
+        }
+    }
+    return CSRSparseMatrix<double, uint32_t>(n * n * n, n * n * n, move(values), move(colIndices),
+                                             move(rowPointers), 0.0);
+}
+
+// Перенумерація, обсяг стрічки й профіль, SpMV у новій нумерації; результат повертається
+// до старої нумерації й порівнюється з reference
+void measureOrdering(const char* label, const CSRSparseMatrix<double, uint32_t>& matrix,
+                     const vector<size_t>& permutation, const vector<double>& x, const vector<double>& reference) {
+    CSRSparseMatrix<double, uint32_t> permuted = permuteSymmetric<uint32_t>(matrix, permutation);
+    vector<double> px = permuteVector(x, permutation);
+    BandwidthProfile shape = bandwidthProfile(permuted);
+    
+    const int repeats = 10;
+    vector<double> y;
+    double seconds = measureSeconds([&]() {
+        for (int k = 0; k < repeats; ++k) y = permuted.multiplyVector(px);
+    });
+    vector<double> back = unpermuteVector(y, permutation);
+    double maxDiff = 0;
+    for (size_t i = 0; i < back.size(); ++i) maxDiff = max(maxDiff, fabs(back[i] - reference[i]));
+    cout << "  " << label << ": bandwidth " << shape.bandwidth << ", profile " << shape.profile << ", SpMV "
+         << seconds / repeats * 1e3 << " ms, max difference " << maxDiff << "\n";
+}
+
+void benchmarkReordering() {
+    cout << "\n=== Matrix reordering (3D Laplacian 100^3, randomly numbered) ===\n";
+    CSRSparseMatrix<double, uint32_t> grid = gridLaplacianCSR(100);
+    vector<size_t> shuffle(grid.getRows());
+    for (size_t i = 0; i < shuffle.size(); ++i) shuffle[i] = i;
+    std::shuffle(shuffle.begin(), shuffle.end(), mt19937_64(13));
+    CSRSparseMatrix<double, uint32_t> scrambled = permuteSymmetric<uint32_t>(grid, shuffle);
+    
+    vector<double> x(scrambled.getCols());
+    for (size_t i = 0; i < x.size(); ++i) x[i] = 1.0 / (i % 13 + 1);
+    vector<double> reference = scrambled.multiplyVector(x);
+    
+    vector<size_t> identity(scrambled.getRows());
+    for (size_t i = 0; i < identity.size(); ++i) identity[i] = i;
+    vector<size_t> rcm, bisection;
+    double rcmSeconds = measureSeconds([&]() { rcm = reverseCuthillMcKee(scrambled); });
+    double bisectionSeconds = measureSeconds([&]() { bisection = recursiveBisection(scrambled); });
+    cout << "Ordering time: RCM " << rcmSeconds << " s, recursive bisection " << bisectionSeconds << " s\n";
+    
+    measureOrdering("random", scrambled, identity, x, reference);
+    measureOrdering("RCM", scrambled, rcm, x, reference);
+    measureOrdering("recursive bisection", scrambled, bisection, x, reference);
+}
+
+// k окремих multiplyVector проти одного multiplyDense над блоком із k векторів
+void benchmarkMultiVector() {
+    cout << "\n=== Multi-vector SpMV (FEM-like, 3x3 blocks, 30000 nodes) ===\n";
+    CSRSparseMatrix<double, uint32_t> csr = randomBlockCSR(30000, 9, 3, 11);
+    size_t n = csr.getCols();
+    
+    for (size_t k : {1, 4, 8, 12, 16, 32}) {
+        vector<double> X(n * k);
+        for (size_t i = 0; i < X.size(); ++i) X[i] = 1.0 / (i % 17 + 1);
+        vector<vector<double>> columns(k, vector<double>(n));
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t c = 0; c < k; ++c) columns[c][i] = X[i * k + c];
+        }
+        
+        vector<vector<double>> separate(k);
+        double separateSeconds = measureSeconds([&]() {
+            for (size_t c = 0; c < k; ++c) separate[c] = csr.multiplyVector(columns[c]);
+        });
+        vector<double> Y;
+        double blockSeconds = measureSeconds([&]() { Y = csr.multiplyDense(X, k); });
+        
+        bool same = true;
+        for (size_t i = 0; i < csr.getRows(); ++i) {
+            for (size_t c = 0; c < k; ++c) same = same && Y[i * k + c] == separate[c][i];
+        }
+        cout << "k = " << k << ": " << k << " x multiplyVector " << separateSeconds * 1e3 << " ms, multiplyDense "
+             << blockSeconds * 1e3 << " ms" << (same ? "" : " (MISMATCH)") << "\n";
+    }
+}
+
+// Розв'язання з кожним передобумовлювачем; перевіряється справжня нев'язка й відхилення від відомого x
+template<typename Solver>
+void compareSolvers(const char* solverName, Solver solve, const CSRSparseMatrix<double, uint32_t>& matrix,
+                    const vector<double>& b, const vector<double>& expected) {
+    SolverOptions options;
+    options.tolerance = 1e-8;
+    options.maxIterations = 2000;
+    
+    vector<unique_ptr<Preconditioner<double>>> preconditioners;
+    preconditioners.push_back(nullptr);
+    vector<double> setup(1, 0.0);
+    setup.push_back(measureSeconds([&]() { preconditioners.emplace_back(new JacobiPreconditioner<double>(matrix)); }));
+    setup.push_back(measureSeconds([&]() { preconditioners.emplace_back(new SSORPreconditioner<double>(matrix, 1.2)); }));
+    setup.push_back(measureSeconds([&]() { preconditioners.emplace_back(new ILU0Preconditioner<double>(matrix)); }));
+    
+    for (size_t k = 0; k < preconditioners.size(); ++k) {
+        vector<double> x;
+        SolverResult result = solve(matrix, b, x, preconditioners[k].get(), options);
+        double maxError = 0;
+        for (size_t i = 0; i < x.size(); ++i) maxError = max(maxError, fabs(x[i] - expected[i]));
+        cout << "  " << solverName << " + " << (preconditioners[k] ? preconditioners[k]->name() : string("none"))
+             << " (setup " << setup[k] * 1e3 << " ms): " << result.toString() << ", max error " << maxError << "\n";
+    }
+}
+
+void benchmarkIterativeSolvers() {
+    const size_t n = 40;
+    cout << "\n=== Iterative solvers (3D grid " << n << "^3, tolerance 1e-8) ===\n";
+    vector<double> expected(n * n * n);
+    for (size_t i = 0; i < expected.size(); ++i) expected[i] = 1.0 + 0.5 * sin(0.01 * i);
+    
+    cout << "Symmetric positive definite (Laplacian):\n";
+    CSRSparseMatrix<double, uint32_t> laplacian = gridLaplacianCSR(n);
+    vector<double> b = laplacian.multiplyVector(expected);
+    compareSolvers("CG", conjugateGradient<double>, laplacian, b, expected);
+    
+    cout << "Nonsymmetric (convection-diffusion):\n";
+    CSRSparseMatrix<double, uint32_t> convection = gridLaplacianCSR(n, 2.0);
+    b = convection.multiplyVector(expected);
+    compareSolvers("BiCGSTAB", biCGSTAB<double>, convection, b, expected);
+    compareSolvers("GMRES(30)", gmres<double>, convection, b, expected);
+    
+    // Як швидко спадає нев'язка: кожна десята ітерація CG без передобумовлювача
+    vector<double> x;
+    SolverResult plain = conjugateGradient(laplacian, laplacian.multiplyVector(expected), x);
+    cout << "CG residual history:";
+    for (size_t k = 0; k < plain.residualHistory.size(); k += 10) cout << " " << plain.residualHistory[k];
+    cout << "\n";
+}
+
+void runBenchmarks() {
+    benchmarkConcurrentSparseList();
+    benchmarkLockFreeAccumulation();
+    benchmarkMatrixAssembly();
+    benchmarkBatchAccess();
+    benchmarkSparseDot();
+    benchmarkTranspose();
+    benchmarkBlockSpMV();
+    benchmarkIndexCompression();
+    benchmarkMixedPrecision();
+    benchmarkReordering();
+    benchmarkMultiVector();
+    benchmarkIterativeSolvers();
+}
+
 void interactiveMenu() {
     while (true) {
         cout << "MAIN MENU:\n";
@@ -691,6 +1383,7 @@ void interactiveMenu() {
         cout << "4. Sequences\n";
         cout << "5. Demonstrate Polymorphism\n";
         cout << "6. Run All Demonstrations\n";
+        cout << "7. Performance Benchmarks\n";
         cout << "0. Exit\n";
         cout << "Select option: ";
         
@@ -711,6 +1404,8 @@ void interactiveMenu() {
             demonstratePolymorphism();
         } else if (choice == 6) {
             runAllDemonstrations();
+        } else if (choice == 7) {
+            runBenchmarks();
         } else {
             cout << "Invalid choice!\n";
         }